@@ -331,6 +331,8 @@ class RobotLaunchGenerator(LaunchGenerator):
         platform_service_launch_writer.add(self.platform_launch_file)
 
         for component in self.platform_components[self.platform_model]:
+            if component is self.puma_node and self.puma_direct_can():
+                continue
             platform_service_launch_writer.add(component)
 
         if self.bms_launch_file:
@@ -338,6 +340,16 @@ class RobotLaunchGenerator(LaunchGenerator):
 
         platform_service_launch_writer.generate_file()
 
+    def puma_direct_can(self) -> bool:
+        # With direct CAN, PumaHardware owns the Puma controllers and multi_puma_node must
+        # stay off the bus. Enabled through the platform extras:
+        #   ros_parameters:
+        #     puma_control:
+        #       direct_can: true
+        ros_parameters = self.clearpath_config.platform.extras.ros_parameters or {}
+        puma_control = ros_parameters.get('puma_control') or {}
+        return bool(puma_control.get('direct_can', False))
+
     def generate_manipulators(self) -> None:
         manipulator_service_launch_writer = LaunchWriter(self.manipulators_service_launch_file)
         if self.clearpath_config.manipulators.get_all_manipulators():
@@ -64,13 +64,30 @@ private:
   void limitDifferentialSpeed(double &diff_speed_left, double &diff_speed_right);
   void updateJointsFromHardware();
   void readStatusFromHardware();
+  void checkConnection(bool answered);
   uint8_t isLeft(const std::string &str);
 
   // ROS Parameters
   std::string serial_port_;
   double polling_timeout_;
+  bool adaptive_polling_timeout_;
+  double polling_timeout_margin_;
+  bool ack_type_fallback_;
   double wheel_diameter_, max_accel_, max_speed_;
 
+  // Only transmit commands that changed, plus a keepalive ahead of the MCU timeout
+  bool command_suppression_;
+  double command_tolerance_;
+  std::chrono::steady_clock::duration keepalive_period_;
+  bool command_sent_;
+  double last_speed_left_, last_speed_right_;
+  std::chrono::steady_clock::time_point last_command_time_;
+  unsigned long suppressed_commands_;
+
+  // Reopen the port after this many polls in a row go unanswered
+  unsigned int reconnect_timeouts_;
+  unsigned int unanswered_polls_;
+
   // Store the command for the robot
   std::vector<double> hw_commands_;
   std::vector<double> hw_states_position_, hw_states_position_offset_, hw_states_velocity_;
@@ -48,7 +48,9 @@
 #ifndef CLEARPATH_TRANSPORT_H
 #define CLEARPATH_TRANSPORT_H
 
+#include <chrono>
 #include <list>
+#include <map>
 #include <iostream>
 
 #include "clearpath_hardware_interfaces/a200/horizon_legacy/Message.h"
@@ -66,7 +68,8 @@ namespace clearpath
       NOT_CONFIGURED,
       CONFIGURE_FAIL,
       UNACKNOWLEDGED_SEND,
-      BAD_ACK_RESULT
+      BAD_ACK_RESULT,
+      TOO_MANY_REQUESTS
     };
   public:
     enum errors type;
@@ -102,11 +105,40 @@ namespace clearpath
       GARBLE_BYTES, // bytes with no SOH / bad length
       INVALID_MSG,  // bad format / CRC wrong
       IGNORED_ACK,  // ack we didn't care about
+      LATE_ACK,     // ack for a request that had already expired
       QUEUE_FULL,   // dropped msg because of overfull queue
+      RETRANSMIT,   // request resent after missing its ack
+      EXPIRED_REQUEST, // request expired before its ack / reply arrived
+      ADAPTIVE_DEADLINE, // request given a deadline tighter than its timeout
+      STALL_AVOIDED, // request expired early on its adaptive deadline
+      TX_MESSAGES,  // messages written, including retransmissions
+      TX_BYTES,     // bytes written
       NUM_COUNTERS  // end of list, not actual counter
     };
     static const char *counter_names[NUM_COUNTERS]; // N.B: must be updated with counterTypes
 
+    typedef unsigned long RequestId;
+
+    enum requestStatus
+    {
+      REQUEST_PENDING,  // waiting for ack and/or data reply
+      REQUEST_COMPLETE, // acked, and reply received if one was expected
+      REQUEST_REJECTED, // acked with a nonzero result code
+      REQUEST_TIMEOUT,  // deadline passed, or never acknowledged
+      REQUEST_UNKNOWN   // no such request (never issued, or already collected)
+    };
+
+    // Outgoing traffic classes, highest priority first
+    enum trafficClass
+    {
+      TRAFFIC_COMMAND,  // motion setpoints; never held back by a budget
+      TRAFFIC_DATA,     // feedback requests (encoders, speeds, ...)
+      TRAFFIC_CONFIG,   // other set commands (limits, gains, ...)
+      TRAFFIC_STATUS,   // status and information requests
+      NUM_TRAFFIC_CLASSES
+    };
+    static const char *traffic_class_names[NUM_TRAFFIC_CLASSES];
+
 
   private:
     bool configured;
@@ -120,10 +152,95 @@ namespace clearpath
 
     unsigned long counters[NUM_COUNTERS];
 
+    typedef std::chrono::steady_clock Clock;
+
+    /* A message that has been written out and is still owed an ack and/or
+     * a data reply.  Replies are matched by message type, oldest first. */
+    struct PendingRequest
+    {
+      RequestId id;
+      Message *msg;           // copy of the sent message, kept for retransmission
+      uint16_t reply_type;    // expected data type, or 0 if only an ack is expected
+      int transmit_times;
+      Clock::time_point issued;
+      Clock::time_point retry_deadline;
+      Clock::time_point deadline;
+      bool adaptive;          // deadline was derived from measured latency
+      enum trafficClass traffic;
+      bool queued;            // waiting for the scheduler to (re)transmit it
+      Clock::time_point queued_at;
+      enum requestStatus status;
+      bool acked;
+      unsigned int result_code;
+      Message *reply;
+    };
+
+    std::list<PendingRequest> pending;
+    RequestId next_request_id;
+    static const size_t MAX_PENDING_REQUESTS = 32;
+
+    /* Recent round trip times for one message type, used to derive
+     * adaptive deadlines. */
+    struct LatencyStats
+    {
+      static const size_t WINDOW = 128;
+      double samples[WINDOW];
+      size_t count;
+      size_t next;
+      double percentile;      // cached LATENCY_PERCENTILE of the window
+    };
+
+    std::map<uint16_t, LatencyStats> latencies;
+
+    /* Acks still owed to requests that expired unacknowledged, by type */
+    std::map<uint16_t, unsigned int> late_acks;
+    bool adaptive_timeout;
+    double adaptive_margin;
+    bool ack_type_fallback;
+    static const size_t MIN_LATENCY_SAMPLES = 20;
+    static constexpr double LATENCY_PERCENTILE = 0.99;
+
+    /* Per-class TX budget (a token bucket in bytes) and queueing statistics */
+    struct TrafficStats
+    {
+      double tokens;
+      unsigned long messages;
+      unsigned long bytes;
+      double total_delay;
+      double max_delay;
+    };
+
+    TrafficStats traffic[NUM_TRAFFIC_CLASSES];
+    static const double TRAFFIC_SHARE[NUM_TRAFFIC_CLASSES];
+    Clock::time_point budget_refilled;
+    Clock::time_point link_free_at;   // when the last written frame will have left the wire
+
+    // 115200 bps, 8-N-1: ten bits on the wire per byte
+    static constexpr double LINK_BYTES_PER_SEC = 115200.0 / 10.0;
+    static constexpr double BUDGET_BURST = 0.1;  // seconds of budget a class may save up
+
   private:
     Message *rxMessage();
 
-    Message *getAck();
+    void dispatch(Message *msg);
+
+    bool matchAck(Message *ack);
+
+    bool matchReply(Message *msg);
+
+    void expireRequests();
+
+    void writeMessage(Message *m);
+
+    void scheduleTx();
+
+    void recordLatency(const PendingRequest &req, Clock::time_point now);
+
+    std::list<PendingRequest>::iterator findRequest(RequestId id);
+
+    void releaseRequest(std::list<PendingRequest>::iterator req);
+
+    void clearRequests();
 
     void enqueueMessage(Message *msg);
 
@@ -133,6 +250,8 @@ namespace clearpath
 
     void resetCounters();
 
+    void resetTraffic();
+
   protected:
     Transport();
 
@@ -154,6 +273,33 @@ namespace clearpath
 
     void send(Message *m);
 
+    RequestId issue(Message *m, double timeout, uint16_t reply_type = 0);
+
+    RequestId issue(Message *m, double timeout, uint16_t reply_type, enum trafficClass cls);
+
+    static enum trafficClass trafficClassOf(uint16_t type);
+
+    enum requestStatus status(RequestId id);
+
+    enum requestStatus collect(RequestId id, Message **reply = 0, unsigned int *result_code = 0);
+
+    enum requestStatus wait(RequestId id, Message **reply = 0, unsigned int *result_code = 0);
+
+    size_t pendingRequests()
+    {
+      return pending.size();
+    }
+
+    void setAdaptiveTimeout(bool enabled, double margin);
+
+    void setAckTypeFallback(bool enabled);
+
+    double getLatency(uint16_t type);
+
+    double getQueueDelay(enum trafficClass cls);
+
+    double getMaxQueueDelay(enum trafficClass cls);
+
     Message *popNext();
 
     Message *popNext(enum MessageTypes type);
@@ -108,6 +108,36 @@ namespace horizon_legacy
       return Ptr(update);
     }
 
+    /**
+    * Request a single update without waiting for it.
+    * Several requests may be outstanding at once; collect each with collectRequest().
+    */
+    static clearpath::Transport::RequestId issueRequest(double timeout)
+    {
+      clearpath::Request request(T::getTypeID() - 0x4000, 0);
+      return clearpath::Transport::instance().issue(&request, timeout, T::getTypeID());
+    }
+
+    /**
+    * Block until a request made by issueRequest() completes or passes its deadline.
+    * Returns an empty pointer if it was not answered in time; rather than blocking
+    * further here, the caller issues a fresh request on its next cycle.
+    */
+    static Ptr collectRequest(clearpath::Transport::RequestId id)
+    {
+      clearpath::Message *reply = 0;
+      if (clearpath::Transport::instance().wait(id, &reply) == clearpath::Transport::REQUEST_COMPLETE)
+      {
+        T *update = dynamic_cast<T *>(reply);
+        if (update)
+        {
+          return Ptr(update);
+        }
+      }
+      delete reply;
+      return Ptr();
+    }
+
     static void subscribe(double frequency)
     {
       T::subscribe(frequency);
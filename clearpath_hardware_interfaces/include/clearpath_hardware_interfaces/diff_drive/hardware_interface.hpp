@@ -34,17 +34,24 @@
 #ifndef CLEARPATH_HARDWARE_INTERFACES__DIFF_DRIVE_HARDWARE_INTERFACE_HPP_
 #define CLEARPATH_HARDWARE_INTERFACES__DIFF_DRIVE_HARDWARE_INTERFACE_HPP_
 
-#include <mutex>
-
 #include "rclcpp/rclcpp.hpp"
 
 #include "clearpath_platform_msgs/msg/drive.hpp"
 #include "clearpath_platform_msgs/msg/feedback.hpp"
 
+#include "clearpath_hardware_interfaces/triple_buffer.hpp"
+
 namespace clearpath_hardware_interfaces
 {
 
-
+// The parts of a Feedback message used by the hardware plugin
+struct DiffDriveFeedback
+{
+  double measured_travel[2];
+  double measured_velocity[2];
+  uint64_t sequence;  // number of Feedback messages received, 0 if none yet
+  int64_t stamp;  // steady clock arrival time in nanoseconds
+};
 
 class DiffDriveHardwareInterface
 : public rclcpp::Node
@@ -52,16 +59,17 @@ class DiffDriveHardwareInterface
   public:
   explicit DiffDriveHardwareInterface(std::string node_name);
   void drive_command(const float & left_wheel, const float & right_wheel, const int8_t & mode);
-  clearpath_platform_msgs::msg::Feedback get_feedback();
+  bool get_feedback(DiffDriveFeedback & feedback);
 
   private:
   void feedback_callback(const clearpath_platform_msgs::msg::Feedback::SharedPtr msg);
 
   rclcpp::Publisher<clearpath_platform_msgs::msg::Drive>::SharedPtr drive_pub_;
+  clearpath_platform_msgs::msg::Drive drive_msg_;
   rclcpp::Subscription<clearpath_platform_msgs::msg::Feedback>::SharedPtr feedback_sub_;
 
-  clearpath_platform_msgs::msg::Feedback feedback_;
-  std::mutex feedback_mutex_;
+  TripleBuffer<DiffDriveFeedback> feedback_;
+  uint64_t feedback_sequence_;
 };
 
 }  // namespace clearpath_hardware_interfaces
@@ -0,0 +1,107 @@
+/**
+Software License Agreement (BSD)
+\file      executor_thread.hpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CLEARPATH_HARDWARE_INTERFACES__EXECUTOR_THREAD_HPP_
+#define CLEARPATH_HARDWARE_INTERFACES__EXECUTOR_THREAD_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "rclcpp/rclcpp.hpp"
+
+namespace clearpath_hardware_interfaces
+{
+
+/**
+ * @brief Spins a hardware interface node on its own thread, so that
+ * subscription callbacks never run inside read() or write().
+ */
+class ExecutorThread
+{
+public:
+  ExecutorThread()
+  : running_(false)
+  {}
+
+  ExecutorThread(const ExecutorThread &) = delete;
+  ExecutorThread & operator=(const ExecutorThread &) = delete;
+
+  ~ExecutorThread()
+  {
+    stop();
+  }
+
+  /**
+   * @brief Start spinning node, stopping any node spun before
+   */
+  void start(const rclcpp::Node::SharedPtr & node)
+  {
+    stop();
+    node_ = node;
+    executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    executor_->add_node(node_);
+    running_ = true;
+    thread_ = std::thread(
+      [this]()
+      {
+        while (running_ && rclcpp::ok())
+        {
+          executor_->spin_once(std::chrono::milliseconds(100));
+        }
+      });
+  }
+
+  /**
+   * @brief Stop the executor thread and release the node. Safe to call when not started.
+   */
+  void stop()
+  {
+    if (executor_)
+    {
+      running_ = false;
+      executor_->cancel();
+      if (thread_.joinable())
+      {
+        thread_.join();
+      }
+      executor_->remove_node(node_);
+      executor_.reset();
+      node_.reset();
+    }
+  }
+
+  bool running() const
+  {
+    return static_cast<bool>(executor_);
+  }
+
+private:
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
+  std::thread thread_;
+  std::atomic_bool running_;
+};
+
+}  // namespace clearpath_hardware_interfaces
+
+#endif  // CLEARPATH_HARDWARE_INTERFACES__EXECUTOR_THREAD_HPP_
@@ -0,0 +1,110 @@
+/**
+ *
+ *  \file
+ *  \brief      Puma Motor direct CAN bus access for the hardware plugin
+ *  \author     Luis Camero <lcamero@clearpathrobotics.com>
+ *  \copyright  Copyright (c) 2025, Clearpath Robotics, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Clearpath Robotics, Inc. nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CLEARPATH ROBOTICS, INC. BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please send comments, questions, or patches to code@clearpathrobotics.com
+ *
+ */
+#ifndef CLEARPATH_HARDWARE_INTERFACES__PUMA_DIRECT_CAN_HPP_
+#define CLEARPATH_HARDWARE_INTERFACES__PUMA_DIRECT_CAN_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "can_msgs/msg/frame.hpp"
+#include "clearpath_ros2_socketcan_interface/socketcan_interface.hpp"
+
+#include "puma_motor_driver/can_rx_batch.hpp"
+#include "puma_motor_driver/can_tx_batch.hpp"
+#include "puma_motor_driver/device_table.hpp"
+#include "puma_motor_driver/driver.hpp"
+
+namespace clearpath_hardware_interfaces
+{
+
+/**
+ * @brief Drives the Puma motor controllers from inside the hardware plugin, without
+ * the multi_puma_node and its command and feedback topics in between.
+ *
+ * Not thread safe; every method is meant to be called from read() or write().
+ */
+class PumaDirectCan
+{
+  public:
+  struct Config
+  {
+    std::string canbus_dev;
+    int encoder_cpr;
+    double gear_ratio;
+    double gain_p, gain_i, gain_d;
+    bool batch_tx;
+    // Period of streamed status in ms, 0 to poll feedback every cycle
+    uint16_t periodic_status_ms;
+    // Configure all parameters in one burst per cycle
+    bool pipelined_configuration;
+    // Synchronous update group bit mask, 0 to apply set-points on arrival
+    uint8_t sync_group;
+    // Receive through a filtered raw socket instead of the SocketCAN interface, needs batch_tx
+    bool raw_rx;
+    // Seconds after which speed and travel are too old to report
+    double feedback_timeout;
+  };
+
+  PumaDirectCan(
+    std::shared_ptr<rclcpp::Node> node, const Config & config,
+    const std::vector<std::string> & joint_names,
+    const std::vector<uint8_t> & can_ids,
+    const std::vector<int> & directions);
+
+  void receive();
+  void requestFeedback();
+  bool getFeedback(uint8_t joint, double & speed, double & travel);
+  void command(uint8_t joint, double velocity);
+  void sync();
+  void flush();
+  bool isActive() const {return active_;}
+
+  private:
+  std::shared_ptr<clearpath_ros2_socketcan_interface::SocketCANInterface> interface_;
+  // Sends each cycle's frames together when batch_tx is set, otherwise nullptr
+  std::shared_ptr<puma_motor_driver::CanTxBatch> tx_batch_;
+  // Receives the drivers' frames directly when raw_rx and batch_tx are set, otherwise nullptr
+  std::unique_ptr<puma_motor_driver::CanRxBatch> rx_batch_;
+  std::vector<puma_motor_driver::Driver> drivers_;
+  puma_motor_driver::DeviceTable device_drivers_;
+  can_msgs::msg::Frame::SharedPtr recv_msg_;
+  uint8_t sync_group_;
+  double feedback_timeout_;
+  bool active_;
+};
+
+}  // namespace clearpath_hardware_interfaces
+
+#endif  // CLEARPATH_HARDWARE_INTERFACES__PUMA_DIRECT_CAN_HPP_
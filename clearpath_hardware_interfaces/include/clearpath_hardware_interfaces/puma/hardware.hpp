@@ -45,6 +45,8 @@
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 #include "hardware_interface/visibility_control.h"
 
+#include "clearpath_hardware_interfaces/executor_thread.hpp"
+#include "clearpath_hardware_interfaces/puma/direct_can.hpp"
 #include "clearpath_hardware_interfaces/puma/hardware_interface.hpp"
 
 
@@ -61,6 +63,8 @@ class PumaHardware : public hardware_interface::SystemInterface
 public:
   RCLCPP_SHARED_PTR_DEFINITIONS(PumaHardware)
 
+  ~PumaHardware() override;
+
   HARDWARE_INTERFACE_PUBLIC
   hardware_interface::CallbackReturn on_init(const hardware_interface::HardwareInfo & info) override;
 
@@ -87,16 +91,27 @@ protected:
   virtual hardware_interface::CallbackReturn getHardwareInfo(const hardware_interface::HardwareInfo & info);
   virtual hardware_interface::CallbackReturn validateJoints();
   virtual hardware_interface::CallbackReturn initHardwareInterface();
+  hardware_interface::CallbackReturn initDirectCan();
   std::shared_ptr<PumaHardwareInterface> node_;
 
+  // Direct CAN mode drives the Puma controllers from read() and write() instead of
+  // going through the multi_puma_node topics
+  bool direct_can_;
+  std::shared_ptr<rclcpp::Node> can_node_;
+  std::unique_ptr<PumaDirectCan> can_;
+
   // Store the command for the robot
   std::vector<double> hw_commands_;
   std::vector<double> hw_states_position_, hw_states_position_offset_, hw_states_velocity_;
 
-  std::map<std::string, uint8_t> wheel_joints_;
+  // Drive command, joint names filled in export_command_interfaces() and velocities in place
+  sensor_msgs::msg::JointState cmd_msg_;
 
   uint8_t num_joints_;
   std::string hw_name_;
+
+  // Spins node_ off the realtime thread
+  ExecutorThread executor_;
 };
 
 }  // namespace clearpath_hardware_interfaces
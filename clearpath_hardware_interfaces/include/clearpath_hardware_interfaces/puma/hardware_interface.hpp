@@ -39,27 +39,45 @@
 #include "clearpath_motor_msgs/msg/puma_feedback.hpp"
 #include "clearpath_motor_msgs/msg/puma_multi_feedback.hpp"
 
+#include "clearpath_hardware_interfaces/triple_buffer.hpp"
+
 namespace clearpath_hardware_interfaces
 {
 
+static constexpr uint8_t PUMA_MAX_JOINTS = 4;
+static constexpr uint8_t PUMA_MAX_DEVICES = 64;  // CAN device numbers are 6 bits
+
+// The parts of a PumaMultiFeedback message used by the hardware plugin, indexed by joint
+struct PumaJointFeedback
+{
+  double speed[PUMA_MAX_JOINTS];
+  double travel[PUMA_MAX_JOINTS];
+  uint64_t sequence;  // number of PumaMultiFeedback messages received, 0 if none yet
+};
+
 class PumaHardwareInterface
 : public rclcpp::Node
 {
   public:
-  explicit PumaHardwareInterface(std::string node_name);
+  PumaHardwareInterface(std::string node_name, const std::vector<std::string> & joint_names);
 
-  void drive_command(const sensor_msgs::msg::JointState msg);
+  void drive_command(const sensor_msgs::msg::JointState & msg);
 
-  bool has_new_feedback();
   void feedback_callback(const clearpath_motor_msgs::msg::PumaMultiFeedback::SharedPtr msg);
-  clearpath_motor_msgs::msg::PumaMultiFeedback get_feedback();
+  bool get_feedback(PumaJointFeedback & feedback);
 
   private:
   rclcpp::Publisher<sensor_msgs::msg::JointState>::SharedPtr pub_cmd_;
   rclcpp::Subscription<clearpath_motor_msgs::msg::PumaMultiFeedback>::SharedPtr sub_feedback_;
 
-  clearpath_motor_msgs::msg::PumaMultiFeedback feedback_;
-  std::atomic_bool has_feedback_;
+  int8_t jointIndex(const clearpath_motor_msgs::msg::PumaFeedback & puma);
+
+  std::vector<std::string> joint_names_;
+  // Joint index of each device number, resolved by name the first time the device reports
+  int8_t device_joints_[PUMA_MAX_DEVICES];
+
+  PumaJointFeedback latest_feedback_;
+  TripleBuffer<PumaJointFeedback> feedback_;
 };
 
 } // namespace clearpath_hardware_interfaces
@@ -0,0 +1,90 @@
+/**
+Software License Agreement (BSD)
+\file      sample_queue.hpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CLEARPATH_HARDWARE_INTERFACES__SAMPLE_QUEUE_HPP_
+#define CLEARPATH_HARDWARE_INTERFACES__SAMPLE_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+namespace clearpath_hardware_interfaces
+{
+
+/**
+ * @brief Wait-free single producer, single consumer queue of samples.
+ *
+ * Unlike TripleBuffer, which only keeps the latest value, every sample pushed is
+ * delivered in order. When the queue is full the new sample is dropped.
+ * N must be a power of two.
+ */
+template<typename T, size_t N>
+class SampleQueue
+{
+  static_assert(N != 0 && (N & (N - 1)) == 0, "SampleQueue size must be a power of two");
+
+public:
+  SampleQueue()
+  : samples_(), head_(0), tail_(0)
+  {}
+
+  /**
+   * @brief Writer side: append a sample
+   *
+   * @return false if the queue was full and the sample was dropped
+   */
+  bool push(const T & sample)
+  {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == N)
+    {
+      return false;
+    }
+    samples_[tail & (N - 1)] = sample;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Reader side: take the oldest sample
+   *
+   * @return false if the queue was empty
+   */
+  bool pop(T & sample)
+  {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    sample = samples_[head & (N - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  T samples_[N];
+  std::atomic<size_t> head_;  // advanced by the reader
+  std::atomic<size_t> tail_;  // advanced by the writer
+};
+
+}  // namespace clearpath_hardware_interfaces
+
+#endif  // CLEARPATH_HARDWARE_INTERFACES__SAMPLE_QUEUE_HPP_
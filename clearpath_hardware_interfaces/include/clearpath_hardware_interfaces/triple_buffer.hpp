@@ -0,0 +1,96 @@
+/**
+Software License Agreement (BSD)
+\file      triple_buffer.hpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CLEARPATH_HARDWARE_INTERFACES__TRIPLE_BUFFER_HPP_
+#define CLEARPATH_HARDWARE_INTERFACES__TRIPLE_BUFFER_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+namespace clearpath_hardware_interfaces
+{
+
+/**
+ * @brief Wait-free single producer, single consumer handoff of the latest value.
+ *
+ * The writer fills the back slot and swaps it with the middle slot; the reader
+ * swaps the middle slot with its front slot when the writer has published.
+ * Neither side ever blocks or waits on the other.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+  TripleBuffer()
+  : buffers_(), front_(0), back_(1), middle_(2)
+  {}
+
+  /**
+   * @brief Writer side: slot to fill before calling publish()
+   */
+  T & back()
+  {
+    return buffers_[back_];
+  }
+
+  /**
+   * @brief Writer side: make the back slot the latest value
+   */
+  void publish()
+  {
+    back_ = middle_.exchange(back_ | DIRTY, std::memory_order_acq_rel) & INDEX;
+  }
+
+  void write(const T & value)
+  {
+    back() = value;
+    publish();
+  }
+
+  /**
+   * @brief Reader side: latest published value
+   *
+   * @return true if a value newer than the previous read was published
+   */
+  bool read(T & value)
+  {
+    bool fresh = (middle_.load(std::memory_order_relaxed) & DIRTY) != 0;
+    if (fresh)
+    {
+      front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+    }
+    value = buffers_[front_];
+    return fresh;
+  }
+
+private:
+  static constexpr uint8_t INDEX = 0x3;
+  static constexpr uint8_t DIRTY = 0x4;
+
+  T buffers_[3];
+  uint8_t front_;  // owned by the reader
+  uint8_t back_;   // owned by the writer
+  std::atomic<uint8_t> middle_;
+};
+
+}  // namespace clearpath_hardware_interfaces
+
+#endif  // CLEARPATH_HARDWARE_INTERFACES__TRIPLE_BUFFER_HPP_
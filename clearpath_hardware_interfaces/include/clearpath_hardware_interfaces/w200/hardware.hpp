@@ -46,6 +46,7 @@
 #include "hardware_interface/types/hardware_interface_return_values.hpp"
 #include "hardware_interface/visibility_control.h"
 
+#include "clearpath_hardware_interfaces/executor_thread.hpp"
 #include "clearpath_hardware_interfaces/w200/hardware_interface.hpp"
 
 
@@ -60,6 +61,8 @@ class W200Hardware : public hardware_interface::SystemInterface
 public:
   RCLCPP_SHARED_PTR_DEFINITIONS(W200Hardware)
 
+  ~W200Hardware() override;
+
   HARDWARE_INTERFACE_PUBLIC
   hardware_interface::CallbackReturn on_init(const hardware_interface::HardwareInfo & info) override;
 
@@ -82,7 +85,9 @@ public:
   hardware_interface::return_type write(const rclcpp::Time & time, const rclcpp::Duration & period) override;
 protected:
   void writeCommandsToHardware();
-  void updateJointsFromHardware(const rclcpp::Duration & period);
+  void updateJointsFromHardware();
+  void integrateFeedback(const W200Feedback & feedback);
+  void checkFeedbackAge();
   virtual hardware_interface::CallbackReturn getHardwareInfo(const hardware_interface::HardwareInfo & info);
   virtual hardware_interface::CallbackReturn validateJoints();
   virtual hardware_interface::CallbackReturn initHardwareInterface();
@@ -91,11 +96,28 @@ protected:
   // Store the command for the robot
   std::vector<double> hw_commands_;
   std::vector<double> hw_states_position_, hw_states_position_offset_, hw_states_velocity_;
-
-  std::map<std::string, uint8_t> wheel_joints_;
+  std::vector<double> hw_states_position_measured_;
+
+  // Seconds since the latest feedback arrived, exported as a state interface
+  double feedback_age_;
+  double feedback_timeout_;
+  bool feedback_extrapolation_;
+  bool feedback_stale_;
+  int64_t feedback_stamp_;  // arrival time of the feedback last integrated, 0 if none yet
+
+  // Joint indices, resolved once in export_command_interfaces()
+  struct WheelJoints
+  {
+    uint8_t left_cmd, right_cmd;
+    uint8_t side[DIFF_DRIVE_FOUR_JOINTS];  // LEFT or RIGHT drive side of each joint
+  } wheel_joints_;
+  void resolveWheelJoints();
 
   uint8_t num_joints_;
   std::string hw_name_;
+
+  // Spins node_ off the realtime thread
+  ExecutorThread executor_;
 };
 
 }  // namespace clearpath_hardware_interfaces
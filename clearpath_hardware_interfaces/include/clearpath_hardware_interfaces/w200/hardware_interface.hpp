@@ -39,29 +39,65 @@
 
 #include <std_msgs/msg/float64.hpp>
 
+#include "clearpath_hardware_interfaces/sample_queue.hpp"
+
 namespace clearpath_hardware_interfaces
 {
 
+// Left and right wheel velocities which arrived within the pairing window of each other, or
+// the latest of each side when they have drifted apart
+struct W200Feedback
+{
+  double velocity[2];
+  uint64_t sequence;  // number of pairs formed, 0 if none yet
+  int64_t stamp;  // steady clock arrival time of the older side in nanoseconds
+  bool forced;  // sides further apart than max_feedback_skew, paired because they drifted
+};
+
 class W200HardwareInterface
 : public rclcpp::Node
 {
   public:
-  explicit W200HardwareInterface(std::string node_name);
+  explicit W200HardwareInterface(
+    std::string node_name, double max_feedback_skew = 0.01, double feedback_timeout = 0.1);
   void feedback_left_callback(const std_msgs::msg::Float64::SharedPtr msg);
   void feedback_right_callback(const std_msgs::msg::Float64::SharedPtr msg);
   void drive_command(const float & left_wheel, const float & right_wheel);
-  bool has_new_feedback();
-  std_msgs::msg::Float64 get_left_feedback();
-  std_msgs::msg::Float64 get_right_feedback();
+  bool get_feedback(W200Feedback & feedback);
 
   private:
   rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr pub_left_cmd;
   rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr pub_right_cmd;
+  std_msgs::msg::Float64 msg_left_cmd_, msg_right_cmd_;
   rclcpp::Subscription<std_msgs::msg::Float64>::SharedPtr sub_left_feedback_;
   rclcpp::Subscription<std_msgs::msg::Float64>::SharedPtr sub_right_feedback_;
 
-  std::atomic<std_msgs::msg::Float64> feedback_left_, feedback_right_;
-  std::atomic_bool has_left_feedback_, has_right_feedback_;
+  // Latest unpaired sample from each side, only touched on the executor thread
+  struct Sample
+  {
+    double velocity;
+    int64_t stamp;
+    bool valid;
+  } samples_[2];
+  int64_t max_feedback_skew_;  // nanoseconds
+  // Pair the latest sample of each side regardless of skew after this many consecutive
+  // unpaired samples, or once no pair has formed for feedback_timeout
+  static constexpr uint64_t MAX_UNPAIRED_SAMPLES = 4;
+  int64_t feedback_timeout_;  // nanoseconds
+  int64_t last_pair_stamp_;
+  uint64_t feedback_sequence_;
+  uint64_t unpaired_samples_;
+  uint64_t consecutive_unpaired_;
+  uint64_t forced_pairs_;
+  uint64_t dropped_feedback_;
+
+  // Every pair is queued, so that none are lost when the controller runs slower than feedback
+  SampleQueue<W200Feedback, 16> feedback_;
+
+  void feedback_callback(uint8_t side, double velocity);
+  void publish_command(
+    rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr & pub,
+    std_msgs::msg::Float64 & msg, const double & value);
 };
 
 }  // namespace clearpath_hardware_interfaces
@@ -32,9 +32,11 @@
 #include "clearpath_hardware_interfaces/a200/hardware.hpp"
 
 #include <chrono>
+#include <cinttypes>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <sstream>
 #include <vector>
 
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
@@ -118,7 +120,23 @@ namespace clearpath_hardware_interfaces
 
     limitDifferentialSpeed(diff_speed_left, diff_speed_right);
 
+    auto now = std::chrono::steady_clock::now();
+    if (command_suppression_ && command_sent_ &&
+      std::abs(diff_speed_left - last_speed_left_) <= command_tolerance_ &&
+      std::abs(diff_speed_right - last_speed_right_) <= command_tolerance_ &&
+      now - last_command_time_ < keepalive_period_)
+    {
+      // Unchanged command, and the MCU is not due a keepalive yet
+      suppressed_commands_++;
+      return;
+    }
+
     horizon_legacy::controlSpeed(diff_speed_left, diff_speed_right, max_accel_, max_accel_);
+
+    command_sent_ = true;
+    last_speed_left_ = diff_speed_left;
+    last_speed_right_ = diff_speed_right;
+    last_command_time_ = now;
   }
 
   void A200Hardware::limitDifferentialSpeed(double &diff_speed_left, double &diff_speed_right)
@@ -138,9 +156,14 @@ namespace clearpath_hardware_interfaces
   */
   void A200Hardware::updateJointsFromHardware()
   {
+    // Issue both requests up front so the MCU can answer them back to back
+    auto enc_request =
+      horizon_legacy::Channel<clearpath::DataEncoders>::issueRequest(polling_timeout_);
+    auto speed_request =
+      horizon_legacy::Channel<clearpath::DataDifferentialSpeed>::issueRequest(polling_timeout_);
 
     horizon_legacy::Channel<clearpath::DataEncoders>::Ptr enc =
-      horizon_legacy::Channel<clearpath::DataEncoders>::requestData(polling_timeout_);
+      horizon_legacy::Channel<clearpath::DataEncoders>::collectRequest(enc_request);
     if (enc)
     {
       RCLCPP_DEBUG(
@@ -174,7 +197,7 @@ namespace clearpath_hardware_interfaces
     }
 
     horizon_legacy::Channel<clearpath::DataDifferentialSpeed>::Ptr speed =
-      horizon_legacy::Channel<clearpath::DataDifferentialSpeed>::requestData(polling_timeout_);
+      horizon_legacy::Channel<clearpath::DataDifferentialSpeed>::collectRequest(speed_request);
     if (speed)
     {
       RCLCPP_DEBUG(
@@ -199,6 +222,8 @@ namespace clearpath_hardware_interfaces
       RCLCPP_ERROR(
         rclcpp::get_logger(HW_NAME), "Could not get speed data");
     }
+
+    checkConnection(enc || speed);
   }
 
   /**
@@ -207,8 +232,13 @@ namespace clearpath_hardware_interfaces
   void A200Hardware::readStatusFromHardware()
   {
 
+    auto safety_request =
+      horizon_legacy::Channel<clearpath::DataSafetySystemStatus>::issueRequest(polling_timeout_);
+    auto system_request =
+      horizon_legacy::Channel<clearpath::DataSystemStatus>::issueRequest(polling_timeout_);
+
     auto safety_status =
-      horizon_legacy::Channel<clearpath::DataSafetySystemStatus>::requestData(polling_timeout_);
+      horizon_legacy::Channel<clearpath::DataSafetySystemStatus>::collectRequest(safety_request);
     if (safety_status)
     {
       uint16_t flags = safety_status->getFlags();
@@ -229,7 +259,7 @@ namespace clearpath_hardware_interfaces
 
 
     auto system_status =
-      horizon_legacy::Channel<clearpath::DataSystemStatus>::requestData(polling_timeout_);
+      horizon_legacy::Channel<clearpath::DataSystemStatus>::collectRequest(system_request);
     if (system_status)
     {
       // status_msg_.mcu_uptime = system_status->getUptime();
@@ -257,14 +287,66 @@ namespace clearpath_hardware_interfaces
         rclcpp::get_logger(HW_NAME), "Could not get system_status");
     }
 
+    checkConnection(safety_status || system_status);
+
     status_node_->publish_status(status_msg_);
     status_node_->publish_power(power_msg_);
     status_node_->publish_stop_state(stop_msg_);
     status_node_->publish_temps(driver_left_temp_msg_, driver_right_temp_msg_, motor_left_temp_msg_, motor_right_temp_msg_);
+
+    RCLCPP_DEBUG(
+      rclcpp::get_logger(HW_NAME),
+      "Adaptive deadlines applied: %" PRIu64 ", stalls avoided: %" PRIu64
+      ", encoder latency: %f s",
+      static_cast<uint64_t>(
+        clearpath::Transport::instance().getCounter(clearpath::Transport::ADAPTIVE_DEADLINE)),
+      static_cast<uint64_t>(
+        clearpath::Transport::instance().getCounter(clearpath::Transport::STALL_AVOIDED)),
+      clearpath::Transport::instance().getLatency(clearpath::DATA_ENCODER));
+    RCLCPP_DEBUG(
+      rclcpp::get_logger(HW_NAME),
+      "Transmitted %" PRIu64 " bytes in %" PRIu64 " messages, suppressed %" PRIu64
+      " unchanged commands",
+      static_cast<uint64_t>(
+        clearpath::Transport::instance().getCounter(clearpath::Transport::TX_BYTES)),
+      static_cast<uint64_t>(
+        clearpath::Transport::instance().getCounter(clearpath::Transport::TX_MESSAGES)),
+      static_cast<uint64_t>(suppressed_commands_));
+    RCLCPP_DEBUG(
+      rclcpp::get_logger(HW_NAME),
+      "TX queueing delay (max) command: %f s, data: %f s, status: %f s",
+      clearpath::Transport::instance().getMaxQueueDelay(clearpath::Transport::TRAFFIC_COMMAND),
+      clearpath::Transport::instance().getMaxQueueDelay(clearpath::Transport::TRAFFIC_DATA),
+      clearpath::Transport::instance().getMaxQueueDelay(clearpath::Transport::TRAFFIC_STATUS));
   }
 
 
 
+  /**
+  * Reconnect once the MCU has left reconnect_timeouts_ polls in a row unanswered, as
+  * requestData() does on every timeout. Requests are only collected up to their deadline,
+  * so a single unanswered poll is not taken as a lost link.
+  */
+  void A200Hardware::checkConnection(bool answered)
+  {
+    if (answered)
+    {
+      unanswered_polls_ = 0;
+      return;
+    }
+
+    if (++unanswered_polls_ < reconnect_timeouts_)
+    {
+      return;
+    }
+
+    RCLCPP_ERROR(
+      rclcpp::get_logger(HW_NAME), "No reply from MCU to %u polls, reconnecting",
+      unanswered_polls_);
+    unanswered_polls_ = 0;
+    horizon_legacy::reconnect();
+  }
+
   /**
   * Determines if the joint is left or right based on the joint name
   */
@@ -299,6 +381,45 @@ hardware_interface::CallbackReturn A200Hardware::on_init(const hardware_interfac
   max_speed_ = std::stod(info_.hardware_parameters["max_speed"]);
   polling_timeout_ = std::stod(info_.hardware_parameters["polling_timeout"]);
 
+  // Optionally derive request deadlines from measured link latency, capped by polling_timeout
+  auto adaptive_it = info_.hardware_parameters.find("adaptive_polling_timeout");
+  adaptive_polling_timeout_ =
+    adaptive_it != info_.hardware_parameters.end() && adaptive_it->second == "true";
+  auto margin_it = info_.hardware_parameters.find("polling_timeout_margin");
+  polling_timeout_margin_ =
+    margin_it != info_.hardware_parameters.end() ? std::stod(margin_it->second) : 0.01;
+
+  // Optionally accept an ack of another type for the only request awaiting one, for
+  // firmware that does not echo the acknowledged type
+  auto fallback_it = info_.hardware_parameters.find("ack_type_fallback");
+  ack_type_fallback_ =
+    fallback_it != info_.hardware_parameters.end() && fallback_it->second == "true";
+
+  // Optionally skip sending commands which have not changed, sending a keepalive instead
+  // at a fraction of the MCU command timeout
+  auto suppression_it = info_.hardware_parameters.find("command_suppression");
+  command_suppression_ =
+    suppression_it != info_.hardware_parameters.end() && suppression_it->second == "true";
+  auto tolerance_it = info_.hardware_parameters.find("command_tolerance");
+  command_tolerance_ =
+    tolerance_it != info_.hardware_parameters.end() ? std::stod(tolerance_it->second) : 0.001;
+  auto mcu_timeout_it = info_.hardware_parameters.find("mcu_command_timeout");
+  double mcu_command_timeout =
+    mcu_timeout_it != info_.hardware_parameters.end() ? std::stod(mcu_timeout_it->second) : 0.5;
+  auto keepalive_it = info_.hardware_parameters.find("keepalive_fraction");
+  double keepalive_fraction =
+    keepalive_it != info_.hardware_parameters.end() ? std::stod(keepalive_it->second) : 0.5;
+  keepalive_period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(mcu_command_timeout * keepalive_fraction));
+  command_sent_ = false;
+  suppressed_commands_ = 0;
+
+  // Polls in a row the MCU may leave unanswered before the port is reopened
+  auto reconnect_it = info_.hardware_parameters.find("reconnect_timeouts");
+  reconnect_timeouts_ =
+    reconnect_it != info_.hardware_parameters.end() ? std::stoul(reconnect_it->second) : 3;
+  unanswered_polls_ = 0;
+
   serial_port_ = info_.hardware_parameters["serial_port"];
 
   status_node_ = std::make_shared<a200_status::A200Status>();
@@ -310,6 +431,9 @@ hardware_interface::CallbackReturn A200Hardware::on_init(const hardware_interfac
   horizon_legacy::connect(serial_port_);
   horizon_legacy::configureLimits(max_speed_, max_accel_);
   resetTravelOffset();
+  clearpath::Transport::instance().setAdaptiveTimeout(
+    adaptive_polling_timeout_, polling_timeout_margin_);
+  clearpath::Transport::instance().setAckTypeFallback(ack_type_fallback_);
 
   for (const hardware_interface::ComponentInfo & joint : info_.joints)
   {
@@ -418,6 +542,9 @@ hardware_interface::CallbackReturn A200Hardware::on_activate(const rclcpp_lifecy
     }
   }
 
+  // Always send the first command after activation
+  command_sent_ = false;
+
   RCLCPP_INFO(rclcpp::get_logger(HW_NAME), "System Successfully started!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -427,6 +554,10 @@ hardware_interface::CallbackReturn A200Hardware::on_deactivate(const rclcpp_life
 {
   RCLCPP_INFO(rclcpp::get_logger(HW_NAME), "Stopping ...please wait...");
 
+  std::stringstream counters;
+  clearpath::Transport::instance().printCounters(counters);
+  RCLCPP_INFO(rclcpp::get_logger(HW_NAME), "%s", counters.str().c_str());
+
   RCLCPP_INFO(rclcpp::get_logger(HW_NAME), "System successfully stopped!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
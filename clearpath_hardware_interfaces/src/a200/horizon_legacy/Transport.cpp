@@ -46,6 +46,7 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
@@ -70,7 +71,32 @@ namespace clearpath
       "Garbled bytes",
       "Invalid messages",
       "Ignored acknowledgment",
-      "Message queue overflow"
+      "Late acknowledgment",
+      "Message queue overflow",
+      "Retransmitted requests",
+      "Expired requests",
+      "Adaptive deadlines applied",
+      "Stalls avoided by adaptive deadline",
+      "Transmitted messages",
+      "Transmitted bytes"
+  };
+
+  const int Transport::RETRY_DELAY_MS;
+
+  const char *Transport::traffic_class_names[] = {
+      "command",
+      "data",
+      "config",
+      "status"
+  };
+
+  // Share of the link each class may use.  Commands are never held back,
+  // their share is only what the others leave free for them.
+  const double Transport::TRAFFIC_SHARE[] = {
+      0.25,
+      0.5,
+      0.1,
+      0.15
   };
 
   TransportException::TransportException(const char *msg, enum errors ex_type)
@@ -138,12 +164,19 @@ namespace clearpath
   Transport::Transport() :
       configured(false),
       serial(0),
-      retries(0)
+      retries(0),
+      next_request_id(1),
+      adaptive_timeout(false),
+      adaptive_margin(0.0),
+      ack_type_fallback(false),
+      budget_refilled(Clock::now()),
+      link_free_at(Clock::now())
   {
     for (int i = 0; i < NUM_COUNTERS; ++i)
     {
       counters[i] = 0;
     }
+    resetTraffic();
   }
 
   Transport::~Transport()
@@ -197,6 +230,7 @@ namespace clearpath
       flush();
       retval = closeComm();
     }
+    clearRequests();
     configured = false;
     return retval;
   }
@@ -308,36 +342,272 @@ namespace clearpath
   }
 
 /**
-* Read data until an ack message is found.
-* Any data messages received by this function will be queued.
-* @return  The next ack message, if one is read.
-*          Null if no ack message has been read yet.
+* Route a freshly received message.
+* Acks and data replies belonging to an outstanding request are handed to
+* that request; other data messages are queued, other acks are dropped.
+* @param msg   The received message.  Ownership is taken.
 */
-  Message *Transport::getAck()
+  void Transport::dispatch(Message *msg)
   {
-    Message *msg = NULL;
+    /* Drop invalid messages */
+    if (!msg->isValid())
+    {
+      ++counters[INVALID_MSG];
+      delete msg;
+      return;
+    }
 
-    while ((msg = rxMessage()))
+    if (msg->isData())
     {
-      /* Queue any data messages that turn up */
-      if (msg->isData())
+      if (!matchReply(msg))
       {
         enqueueMessage(msg);
+      }
+      return;
+    }
+
+    if (!matchAck(msg))
+    {
+      ++counters[IGNORED_ACK];
+      delete msg;
+    }
+  }
+
+/**
+* Attach an ack to the oldest unacknowledged request of the same type.
+* An ack owed to a request that already expired is counted as late and
+* never handed to an unrelated one.  Otherwise, with the ack type fallback
+* enabled, an ack matching no request by type is given to the only request
+* awaiting one, for firmware that does not echo the acknowledged type.
+* @param ack   The received ack.  Deleted if it was consumed.
+* @return  true if the ack was consumed.
+*/
+  bool Transport::matchAck(Message *ack)
+  {
+    list<PendingRequest>::iterator match;
+    for (match = pending.begin(); match != pending.end(); ++match)
+    {
+      if (match->status == REQUEST_PENDING && !match->acked &&
+          match->msg->getType() == ack->getType())
+      {
+        break;
+      }
+    }
+
+    if (match == pending.end())
+    {
+      /* Routine with adaptive deadlines, which expire requests early */
+      map<uint16_t, unsigned int>::iterator owed = late_acks.find(ack->getType());
+      if (owed != late_acks.end() && owed->second > 0)
+      {
+        --owed->second;
+        ++counters[LATE_ACK];
+        delete ack;
+        return true;
+      }
+
+      if (!ack_type_fallback) { return false; }
+
+      list<PendingRequest>::iterator iter;
+      for (iter = pending.begin(); iter != pending.end(); ++iter)
+      {
+        if (iter->status != REQUEST_PENDING || iter->acked) { continue; }
+        if (match != pending.end()) { return false; }
+        match = iter;
+      }
+      if (match == pending.end()) { return false; }
+    }
+
+    match->acked = true;
+    match->result_code = btou(ack->getPayloadPointer(), 2);
+    delete ack;
+
+    // If the result code is bad, the message was still transmitted successfully
+    if (match->result_code > 0)
+    {
+      match->status = REQUEST_REJECTED;
+    }
+    else if (!match->reply_type || match->reply)
+    {
+      match->status = REQUEST_COMPLETE;
+      recordLatency(*match, Clock::now());
+    }
+    return true;
+  }
+
+/**
+* Attach a data message to the oldest outstanding request expecting it.
+* @param msg   The received data message.  Ownership is taken if consumed.
+* @return  true if the message was consumed.
+*/
+  bool Transport::matchReply(Message *msg)
+  {
+    list<PendingRequest>::iterator iter;
+    for (iter = pending.begin(); iter != pending.end(); ++iter)
+    {
+      if (iter->status != REQUEST_PENDING || iter->reply) { continue; }
+      if (iter->reply_type != msg->getType()) { continue; }
+
+      iter->reply = msg;
+      if (iter->acked)
+      {
+        iter->status = REQUEST_COMPLETE;
+        recordLatency(*iter, Clock::now());
+      }
+      return true;
+    }
+    return false;
+  }
+
+/**
+* Retransmit requests whose ack is overdue, and fail requests which have
+* run out of retries or passed their deadline.
+*/
+  void Transport::expireRequests()
+  {
+    Clock::time_point now = Clock::now();
+
+    list<PendingRequest>::iterator iter;
+    for (iter = pending.begin(); iter != pending.end(); ++iter)
+    {
+      if (iter->status != REQUEST_PENDING) { continue; }
+
+      if (now >= iter->deadline)
+      {
+        ++counters[EXPIRED_REQUEST];
+        iter->status = REQUEST_TIMEOUT;
+        /* Only a request that went out can still be acked */
+        if (!iter->acked && iter->transmit_times > 0) { ++late_acks[iter->msg->getType()]; }
+        if (iter->adaptive)
+        {
+          /* The round trip took at least this long; feeding that back in
+           * lets the deadline grow if the link has slowed down */
+          ++counters[STALL_AVOIDED];
+          recordLatency(*iter, now);
+        }
         continue;
       }
 
-      /* Drop invalid messages */
-      if (!msg->isValid())
+      if (iter->acked || iter->queued || now < iter->retry_deadline) { continue; }
+
+      // No ack - resend, unless we have exceeded our retry numbers
+      if (iter->transmit_times > this->retries)
       {
-        ++counters[INVALID_MSG];
-        delete msg;
+        ++counters[EXPIRED_REQUEST];
+        iter->status = REQUEST_TIMEOUT;
+        ++late_acks[iter->msg->getType()];
         continue;
       }
+      ++counters[RETRANSMIT];
+      iter->queued = true;
+      iter->queued_at = now;
+    }
+  }
+
+/**
+* Write out the next queued request, if the link is free.
+* Classes are served in priority order.  Each class other than commands
+* may only use its share of the link, so a burst of status traffic cannot
+* crowd out feedback requests.  Only one frame is handed to the serial port
+* at a time, so a command never waits behind more than the frame already
+* on the wire.
+*/
+  void Transport::scheduleTx()
+  {
+    Clock::time_point now = Clock::now();
 
-      return msg;
+    /* Top up each class's budget */
+    double elapsed = std::chrono::duration<double>(now - budget_refilled).count();
+    budget_refilled = now;
+    for (int i = 0; i < NUM_TRAFFIC_CLASSES; ++i)
+    {
+      double rate = TRAFFIC_SHARE[i] * LINK_BYTES_PER_SEC;
+      traffic[i].tokens = std::min(traffic[i].tokens + rate * elapsed, rate * BUDGET_BURST);
     }
 
-    return NULL;
+    if (now < link_free_at) { return; }
+
+    /* Oldest queued request of the highest priority class with budget left */
+    list<PendingRequest>::iterator next = pending.end();
+    list<PendingRequest>::iterator iter;
+    for (iter = pending.begin(); iter != pending.end(); ++iter)
+    {
+      if (iter->status != REQUEST_PENDING || !iter->queued) { continue; }
+      if (iter->traffic != TRAFFIC_COMMAND && traffic[iter->traffic].tokens <= 0.0) { continue; }
+      if (next == pending.end() || iter->traffic < next->traffic) { next = iter; }
+    }
+    if (next == pending.end()) { return; }
+
+    TrafficStats &stats = traffic[next->traffic];
+    double delay = std::chrono::duration<double>(now - next->queued_at).count();
+    stats.messages++;
+    stats.bytes += next->msg->total_len;
+    stats.total_delay += delay;
+    stats.max_delay = std::max(stats.max_delay, delay);
+    stats.tokens -= next->msg->total_len;
+
+    writeMessage(next->msg);
+    next->queued = false;
+    next->transmit_times++;
+    next->retry_deadline = now + std::chrono::milliseconds(RETRY_DELAY_MS);
+    link_free_at = now + std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(next->msg->total_len / LINK_BYTES_PER_SEC));
+  }
+
+/**
+* Write a message out on the serial port, counting the traffic.
+*/
+  void Transport::writeMessage(Message *m)
+  {
+    ++counters[TX_MESSAGES];
+    counters[TX_BYTES] += m->total_len;
+    WriteData(serial, (char *) (m->data), m->total_len);
+  }
+
+/**
+* Add the round trip time of a finished request to the latency window
+* for its type.
+*/
+  void Transport::recordLatency(const PendingRequest &req, Clock::time_point now)
+  {
+    uint16_t type = req.reply_type ? req.reply_type : req.msg->getType();
+    LatencyStats &stats = latencies[type];
+
+    stats.samples[stats.next] = std::chrono::duration<double>(now - req.issued).count();
+    stats.next = (stats.next + 1) % LatencyStats::WINDOW;
+    if (stats.count < LatencyStats::WINDOW) { stats.count++; }
+
+    double sorted[LatencyStats::WINDOW];
+    std::copy(stats.samples, stats.samples + stats.count, sorted);
+    size_t inx = static_cast<size_t>(LATENCY_PERCENTILE * (stats.count - 1));
+    std::nth_element(sorted, sorted + inx, sorted + stats.count);
+    stats.percentile = sorted[inx];
+  }
+
+  list<Transport::PendingRequest>::iterator Transport::findRequest(RequestId id)
+  {
+    list<PendingRequest>::iterator iter;
+    for (iter = pending.begin(); iter != pending.end(); ++iter)
+    {
+      if (iter->id == id) { break; }
+    }
+    return iter;
+  }
+
+  void Transport::releaseRequest(list<PendingRequest>::iterator req)
+  {
+    delete req->msg;
+    delete req->reply;
+    pending.erase(req);
+  }
+
+  void Transport::clearRequests()
+  {
+    while (!pending.empty())
+    {
+      releaseRequest(pending.begin());
+    }
+    late_acks.clear();
   }
 
 /**
@@ -383,17 +653,11 @@ namespace clearpath
 
     while ((msg = rxMessage()))
     {
-      /* We're not waiting for acks, so drop them */
-      if (!msg->isData())
-      {
-        ++counters[IGNORED_ACK];
-        delete msg;
-        continue;
-      }
-
-      // Message is good, queue it.
-      enqueueMessage(msg);
+      dispatch(msg);
     }
+
+    expireRequests();
+    scheduleTx();
   }
 
 /**
@@ -407,62 +671,274 @@ namespace clearpath
   {
     CHECK_THROW_CONFIGURED();
 
-    char skip_send = 0;
-    Message *ack = NULL;
-    int transmit_times = 0;
-    short result_code;
+    unsigned int result_code = 0;
+    enum requestStatus result = wait(issue(m, 0.0), NULL, &result_code);
+
+    if (result == REQUEST_REJECTED)
+    {
+      throw new BadAckException(result_code);
+    }
+    if (result != REQUEST_COMPLETE)
+    {
+      throw new TransportException("Unacknowledged send", TransportException::UNACKNOWLEDGED_SEND);
+    }
+
+    m->is_sent = true;
+  }
+
+/**
+* Send a message without waiting for it to be acknowledged.
+* The request is tracked until its ack (and optionally a data reply) arrives,
+* and is retransmitted as send() would if the ack does not turn up.
+* Progress is made whenever the Transport is polled.
+* @param m          The message to send.  It is copied; the caller keeps ownership.
+* @param timeout    Maximum time for the request to complete, in seconds.
+*                   A timeout of 0.0 indicates no deadline beyond the retries.
+* @param reply_type Type of data message expected in reply, or 0 if the
+*                   request is complete once acknowledged.
+* @return  An id with which to query and collect the request.
+* @throw   TransportException if too many requests are outstanding.
+*/
+  Transport::RequestId Transport::issue(Message *m, double timeout, uint16_t reply_type)
+  {
+    return issue(m, timeout, reply_type, trafficClassOf(m->getType()));
+  }
+
+/**
+* Send a message without waiting for it to be acknowledged, in a given
+* traffic class.
+* @see Transport::issue()
+* @param cls   The traffic class to schedule the message in.
+*/
+  Transport::RequestId Transport::issue(Message *m, double timeout, uint16_t reply_type,
+      enum trafficClass cls)
+  {
+    CHECK_THROW_CONFIGURED();
 
     poll();
 
-    while (1)
+    /* Forget the oldest finished requests nobody has collected */
+    list<PendingRequest>::iterator iter = pending.begin();
+    while (pending.size() >= MAX_PENDING_REQUESTS && iter != pending.end())
     {
-      // We have exceeded our retry numbers
-      if (transmit_times > this->retries)
+      if (iter->status != REQUEST_PENDING)
       {
-        break;
+        releaseRequest(iter++);
       }
-      // Write output
-      if (!skip_send) { WriteData(serial, (char *) (m->data), m->total_len); }
-
-      // Wait up to 100 ms for ack
-      for (int i = 0; i < RETRY_DELAY_MS; ++i)
+      else
       {
-        usleep(1000);
-        if ((ack = getAck())) { break; }
+        ++iter;
       }
+    }
+    if (pending.size() >= MAX_PENDING_REQUESTS)
+    {
+      throw new TransportException("Too many outstanding requests", TransportException::TOO_MANY_REQUESTS);
+    }
 
-      // No message - resend
-      if (ack == NULL)
+    PendingRequest req;
+    req.id = next_request_id++;
+    req.msg = new Message(*m);
+    req.reply_type = reply_type;
+    req.transmit_times = 0;
+    req.issued = Clock::now();
+    req.retry_deadline = req.issued;
+    req.deadline = Clock::time_point::max();
+    req.adaptive = false;
+    if (timeout > 0.0 && adaptive_timeout)
+    {
+      /* Tighten the deadline to what this link has recently needed */
+      double latency = getLatency(reply_type ? reply_type : m->getType());
+      if (latency > 0.0 && latency + adaptive_margin < timeout)
       {
-        skip_send = 0;
-        //cout << "No message received yet" << endl;
-        transmit_times++;
-        continue;
+        timeout = latency + adaptive_margin;
+        req.adaptive = true;
+        ++counters[ADAPTIVE_DEADLINE];
       }
+    }
+    if (timeout > 0.0)
+    {
+      req.deadline = req.issued +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeout));
+    }
+    req.status = REQUEST_PENDING;
+    req.acked = false;
+    req.result_code = 0;
+    req.reply = NULL;
+    req.traffic = cls;
+    req.queued = true;
+    req.queued_at = req.issued;
+    pending.push_back(req);
+
+    scheduleTx();
+
+    return req.id;
+  }
 
-      // Check result code
-      // If the result code is bad, the message was still transmitted
-      // successfully
-      result_code = btou(ack->getPayloadPointer(), 2);
-      if (result_code > 0)
-      {
-        throw new BadAckException(result_code);
-      }
-      else
-      {
-        // Everything's good - return
-        break;
-      }
-      // Other failure
-      transmit_times++;
+/**
+* The traffic class a message is scheduled in by default.
+* @param type  The message type.
+*/
+  enum Transport::trafficClass Transport::trafficClassOf(uint16_t type)
+  {
+    switch (type)
+    {
+      case SET_DIFF_WHEEL_SPEEDS:
+      case SET_DIFF_WHEEL_SETPTS:
+      case SET_ACKERMANN_SETPT:
+      case SET_VELOCITY_SETPT:
+      case SET_TURN_SETPT:
+      case SET_GEAR_SETPOINT:
+        return TRAFFIC_COMMAND;
+
+      case REQUEST_ECHO:
+      case REQUEST_PLATFORM_INFO:
+      case REQUEST_PLATFORM_NAME:
+      case REQUEST_FIRMWARE_INFO:
+      case REQUEST_SYSTEM_STATUS:
+      case REQUEST_POWER_SYSTEM:
+      case REQUEST_SAFETY_SYSTEM:
+        return TRAFFIC_STATUS;
+
+      default:
+        if (type < REQUEST_ECHO) { return TRAFFIC_CONFIG; }
+        return TRAFFIC_DATA;
+    }
+  }
+
+/**
+* Mean time messages of a traffic class have spent queued before being
+* written out.
+* @return  The mean queueing delay in seconds.
+*/
+  double Transport::getQueueDelay(enum trafficClass cls)
+  {
+    if (!traffic[cls].messages) { return 0.0; }
+    return traffic[cls].total_delay / traffic[cls].messages;
+  }
+
+/**
+* Longest time a message of a traffic class has spent queued before being
+* written out.
+* @return  The maximum queueing delay in seconds.
+*/
+  double Transport::getMaxQueueDelay(enum trafficClass cls)
+  {
+    return traffic[cls].max_delay;
+  }
+
+/**
+* Enable or disable adaptive request deadlines.
+* When enabled, issue() shortens a request's timeout to the recently measured
+* round trip time for its type (99th percentile) plus a margin.  The timeout
+* passed to issue() remains the upper bound.
+* @param enabled   Whether to derive deadlines from measured latency.
+* @param margin    Time added to the measured latency, in seconds.
+*/
+  void Transport::setAdaptiveTimeout(bool enabled, double margin)
+  {
+    adaptive_timeout = enabled;
+    adaptive_margin = margin;
+  }
+
+/**
+* Enable or disable the ack type fallback.
+* Acks carry the type of the message they acknowledge, which is how they
+* are matched to requests.  With the fallback enabled, an ack of any other
+* type still completes the only request awaiting one, as the single-message
+* send() of old did.  This is for firmware that does not echo the type; it
+* also lets a stray ack complete an unrelated request, so it is off by
+* default.
+* @param enabled   Whether to match acks of unexpected type.
+*/
+  void Transport::setAckTypeFallback(bool enabled)
+  {
+    ack_type_fallback = enabled;
+  }
+
+/**
+* Recently measured round trip time for a message type.
+* @param type  The data type of a request's reply, or the type of an
+*              ack-only message.
+* @return  The 99th percentile round trip time in seconds, or 0.0 if too
+*          few requests of this type have completed to tell.
+*/
+  double Transport::getLatency(uint16_t type)
+  {
+    std::map<uint16_t, LatencyStats>::iterator stats = latencies.find(type);
+    if (stats == latencies.end() || stats->second.count < MIN_LATENCY_SAMPLES)
+    {
+      return 0.0;
     }
-    if (ack == NULL)
+    return stats->second.percentile;
+  }
+
+/**
+* Check on an outstanding request, without blocking.
+* @param id    The id returned by issue().
+* @return  The current status of the request.
+*/
+  enum Transport::requestStatus Transport::status(RequestId id)
+  {
+    CHECK_THROW_CONFIGURED();
+
+    poll();
+
+    list<PendingRequest>::iterator req = findRequest(id);
+    if (req == pending.end()) { return REQUEST_UNKNOWN; }
+    return req->status;
+  }
+
+/**
+* Collect the result of a request, without blocking.
+* A request which is no longer pending is forgotten once collected.
+* @param id            The id returned by issue().
+* @param reply         If not null, receives the data reply, if there was one.
+*                      It is dynamically allocated; the caller is responsible
+*                      for freeing it.  If null, the reply is deleted.
+* @param result_code   If not null, receives the ack result code.
+* @return  The status of the request.
+*/
+  enum Transport::requestStatus Transport::collect(RequestId id, Message **reply,
+      unsigned int *result_code)
+  {
+    CHECK_THROW_CONFIGURED();
+
+    if (reply) { *reply = NULL; }
+
+    poll();
+
+    list<PendingRequest>::iterator req = findRequest(id);
+    if (req == pending.end()) { return REQUEST_UNKNOWN; }
+
+    enum requestStatus result = req->status;
+    if (result == REQUEST_PENDING) { return result; }
+
+    if (result_code) { *result_code = req->result_code; }
+    if (reply)
     {
-      throw new TransportException("Unacknowledged send", TransportException::UNACKNOWLEDGED_SEND);
+      *reply = req->reply;
+      req->reply = NULL;
     }
-    delete ack;
+    releaseRequest(req);
+    return result;
+  }
 
-    m->is_sent = true;
+/**
+* Block until a request is no longer pending, then collect it.
+* @see Transport::collect()
+*/
+  enum Transport::requestStatus Transport::wait(RequestId id, Message **reply,
+      unsigned int *result_code)
+  {
+    CHECK_THROW_CONFIGURED();
+
+    enum requestStatus result;
+    while ((result = collect(id, reply, result_code)) == REQUEST_PENDING)
+    {
+      // Wait a ms before retry
+      usleep(1000);
+    }
+    return result;
   }
 
 /**
@@ -673,12 +1149,31 @@ namespace clearpath
 
     for (int i = 0; i < NUM_COUNTERS; ++i)
     {
-      cout.width(longest_name);
-      cout << left << counter_names[i] << ": " << counters[i] << endl;
+      stream.width(longest_name);
+      stream << left << counter_names[i] << ": " << counters[i] << endl;
     }
 
-    cout.width(longest_name);
-    cout << left << "Queue length" << ": " << rx_queue.size() << endl;
+    stream.width(longest_name);
+    stream << left << "Queue length" << ": " << rx_queue.size() << endl;
+
+    stream.width(longest_name);
+    stream << left << "Pending requests" << ": " << pending.size() << endl;
+
+    for (int i = 0; i < NUM_TRAFFIC_CLASSES; ++i)
+    {
+      stream << "Queue delay " << traffic_class_names[i] << ": "
+             << getQueueDelay((enum trafficClass) i) * 1000.0 << " ms mean, "
+             << traffic[i].max_delay * 1000.0 << " ms max over "
+             << traffic[i].messages << " messages, " << traffic[i].bytes << " bytes" << endl;
+    }
+
+    std::map<uint16_t, LatencyStats>::iterator iter;
+    for (iter = latencies.begin(); iter != latencies.end(); ++iter)
+    {
+      stream << "Latency 0x" << hex << iter->first << dec << ": "
+             << iter->second.percentile * 1000.0 << " ms p99 over "
+             << iter->second.count << " samples" << endl;
+    }
   }
 
 /**
@@ -690,6 +1185,21 @@ namespace clearpath
     {
       counters[i] = 0;
     }
+    latencies.clear();
+    resetTraffic();
+  }
+
+/**
+* Wipes out queueing statistics and refills every class's budget
+*/
+  void Transport::resetTraffic()
+  {
+    for (int i = 0; i < NUM_TRAFFIC_CLASSES; ++i)
+    {
+      traffic[i] = TrafficStats();
+      traffic[i].tokens = TRAFFIC_SHARE[i] * LINK_BYTES_PER_SEC * BUDGET_BURST;
+    }
+    budget_refilled = Clock::now();
   }
 
 } // namespace clearpath
@@ -36,6 +36,8 @@
 #include "clearpath_platform_msgs/msg/feedback.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 
+#include <limits>
+
 namespace clearpath_hardware_interfaces
 {
 
@@ -44,14 +46,16 @@ static const std::string RIGHT_CMD_JOINT_NAME = "front_right_wheel_joint";
 static const std::string LEFT_ALT_JOINT_NAME = "rear_left_wheel_joint";
 static const std::string RIGHT_ALT_JOINT_NAME = "rear_right_wheel_joint";
 
+static const std::string FEEDBACK_AGE_INTERFACE = "feedback_age";
+
 /**
  * @brief Write commanded velocities to the MCU
  *
  */
 void DiffDriveHardware::writeCommandsToHardware()
 {
-  double diff_speed_left = hw_commands_[wheel_joints_[LEFT_CMD_JOINT_NAME]];
-  double diff_speed_right = hw_commands_[wheel_joints_[RIGHT_CMD_JOINT_NAME]];
+  double diff_speed_left = hw_commands_[wheel_joints_.left_cmd];
+  double diff_speed_right = hw_commands_[wheel_joints_.right_cmd];
 
   if (std::abs(diff_speed_left) < 0.01 && std::abs(diff_speed_right) < 0.01) {
     diff_speed_left = diff_speed_right = 0.0;
@@ -70,49 +74,111 @@ void DiffDriveHardware::writeCommandsToHardware()
  */
 void DiffDriveHardware::updateJointsFromHardware()
 {
-  rclcpp::spin_some(node_);
-  clearpath_platform_msgs::msg::Feedback msg = node_->get_feedback();
-  RCLCPP_DEBUG(
-    rclcpp::get_logger(hw_name_),
-    "Received linear distance information (L: %f, R: %f)",
-    msg.drivers[0].measured_travel, msg.drivers[1].measured_travel);
-
-  auto side = clearpath_platform_msgs::msg::Drive::LEFT;
+  DiffDriveFeedback msg;
+  bool fresh = node_->get_feedback(msg);
+  if (msg.sequence == 0)
+  {
+    // No feedback yet
+    feedback_age_ = std::numeric_limits<double>::infinity();
+    return;
+  }
+
+  auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  feedback_age_ = (now - msg.stamp) * 1e-9;
+  checkFeedbackAge();
+
+  if (fresh) {
+    RCLCPP_DEBUG(
+      rclcpp::get_logger(hw_name_),
+      "Received linear distance information (L: %f, R: %f)",
+      msg.measured_travel[0], msg.measured_travel[1]);
+
+    for (auto i = 0u; i < hw_states_position_.size(); i++) {
+      auto side = wheel_joints_.side[i];
+
+      double delta = msg.measured_travel[side] -
+        hw_states_position_measured_[i] - hw_states_position_offset_[i];
+
+      // detect suspiciously large readings, possibly from encoder rollover
+      if (std::abs(delta) < 1.0f) {
+        hw_states_position_measured_[i] += delta;
+      } else {
+        // suspicious! drop this measurement and update the offset for subsequent readings
+        hw_states_position_offset_[i] += delta;
+        RCLCPP_WARN(
+          rclcpp::get_logger(hw_name_), "Dropping overflow measurement from encoder");
+      }
+
+      // Velocities
+      hw_states_velocity_[i] = msg.measured_velocity[side];
+    }
+  }
+
+  // Optionally project position forward to now using the measured velocity. Once the
+  // feedback is stale, which feedback_age exceeding feedback_timeout reports, the velocity can
+  // no longer be trusted and the measured position is exported as is.
+  double extrapolation = 0.0;
+  if (feedback_extrapolation_ && !feedback_stale_)
+  {
+    extrapolation = feedback_age_;
+  }
+
   for (auto i = 0u; i < hw_states_position_.size(); i++) {
-    if (num_joints_ == DIFF_DRIVE_TWO_JOINTS)
+    hw_states_position_[i] = hw_states_position_measured_[i] +
+      hw_states_velocity_[i] * extrapolation;
+  }
+}
+
+/**
+ * @brief Log when feedback goes stale, or resumes after going stale
+ *
+ */
+void DiffDriveHardware::checkFeedbackAge()
+{
+  bool stale = feedback_age_ > feedback_timeout_;
+  if (stale && !feedback_stale_)
+  {
+    RCLCPP_WARN(
+      rclcpp::get_logger(hw_name_), "Feedback is stale, last received %.3f s ago",
+      feedback_age_);
+  }
+  else if (!stale && feedback_stale_)
+  {
+    RCLCPP_INFO(rclcpp::get_logger(hw_name_), "Feedback resumed");
+  }
+  feedback_stale_ = stale;
+}
+
+/**
+ * @brief Resolve command joint indices and the drive side of every joint,
+ * so that read() and write() never look joints up by name
+ *
+ */
+void DiffDriveHardware::resolveWheelJoints()
+{
+  wheel_joints_.left_cmd = 0;
+  wheel_joints_.right_cmd = 0;
+  for (auto i = 0u; i < num_joints_; i++)
+  {
+    const std::string & name = info_.joints[i].name;
+    if (name == LEFT_CMD_JOINT_NAME)
     {
-      if (i == wheel_joints_[RIGHT_CMD_JOINT_NAME]){
-        side = clearpath_platform_msgs::msg::Drive::RIGHT;
-      }
-      else {
-        side = clearpath_platform_msgs::msg::Drive::LEFT;
-      }
+      wheel_joints_.left_cmd = i;
     }
-    else if (num_joints_ == DIFF_DRIVE_FOUR_JOINTS)
+    else if (name == RIGHT_CMD_JOINT_NAME)
     {
-      if (i == wheel_joints_[RIGHT_CMD_JOINT_NAME] || i == wheel_joints_[RIGHT_ALT_JOINT_NAME]){
-        side = clearpath_platform_msgs::msg::Drive::RIGHT;
-      }
-      else {
-        side = clearpath_platform_msgs::msg::Drive::LEFT;
-      }
+      wheel_joints_.right_cmd = i;
     }
 
-    double delta = msg.drivers[side].measured_travel -
-      hw_states_position_[i] - hw_states_position_offset_[i];
-
-    // detect suspiciously large readings, possibly from encoder rollover
-    if (std::abs(delta) < 1.0f) {
-      hw_states_position_[i] += delta;
-    } else {
-      // suspicious! drop this measurement and update the offset for subsequent readings
-      hw_states_position_offset_[i] += delta;
-      RCLCPP_WARN(
-        rclcpp::get_logger(hw_name_), "Dropping overflow measurement from encoder");
+    if (name == RIGHT_CMD_JOINT_NAME || name == RIGHT_ALT_JOINT_NAME)
+    {
+      wheel_joints_.side[i] = clearpath_platform_msgs::msg::Drive::RIGHT;
+    }
+    else
+    {
+      wheel_joints_.side[i] = clearpath_platform_msgs::msg::Drive::LEFT;
     }
-
-    // Velocities
-    hw_states_velocity_[i] = msg.drivers[side].measured_velocity;
   }
 }
 
@@ -140,9 +206,21 @@ hardware_interface::CallbackReturn DiffDriveHardware::getHardwareInfo(const hard
 
   hw_states_position_.resize(num_joints_);
   hw_states_position_offset_.resize(num_joints_);
+  hw_states_position_measured_.resize(num_joints_);
   hw_states_velocity_.resize(num_joints_);
   hw_commands_.resize(num_joints_);
 
+  // Feedback older than feedback_timeout is reported as stale. Optionally extrapolate
+  // position to the control loop time from the measured velocity.
+  auto timeout_it = info_.hardware_parameters.find("feedback_timeout");
+  feedback_timeout_ =
+    timeout_it != info_.hardware_parameters.end() ? std::stod(timeout_it->second) : 0.1;
+  auto extrapolation_it = info_.hardware_parameters.find("feedback_extrapolation");
+  feedback_extrapolation_ =
+    extrapolation_it != info_.hardware_parameters.end() && extrapolation_it->second == "true";
+  feedback_age_ = std::numeric_limits<double>::infinity();
+  feedback_stale_ = false;
+
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
@@ -213,6 +291,11 @@ hardware_interface::CallbackReturn DiffDriveHardware::initHardwareInterface()
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
+DiffDriveHardware::~DiffDriveHardware()
+{
+  executor_.stop();
+}
+
 hardware_interface::CallbackReturn DiffDriveHardware::on_init(const hardware_interface::HardwareInfo & info)
 {
   hardware_interface::CallbackReturn ret;
@@ -248,6 +331,9 @@ std::vector<hardware_interface::StateInterface> DiffDriveHardware::export_state_
         info_.joints[i].name, hardware_interface::HW_IF_VELOCITY, &hw_states_velocity_[i]));
   }
 
+  state_interfaces.emplace_back(
+    hardware_interface::StateInterface(hw_name_, FEEDBACK_AGE_INTERFACE, &feedback_age_));
+
   return state_interfaces;
 }
 
@@ -260,10 +346,10 @@ std::vector<hardware_interface::CommandInterface> DiffDriveHardware::export_comm
       hardware_interface::CommandInterface(
         info_.joints[i].name, hardware_interface::HW_IF_VELOCITY, &hw_commands_[i]));
 
-    // Map wheel joint name to index
-    wheel_joints_[info_.joints[i].name] = i;
   }
 
+  resolveWheelJoints();
+
   return command_interfaces;
 }
 
@@ -276,11 +362,14 @@ hardware_interface::CallbackReturn DiffDriveHardware::on_activate(const rclcpp_l
     if (std::isnan(hw_states_position_[i])) {
       hw_states_position_[i] = 0;
       hw_states_position_offset_[i] = 0;
+      hw_states_position_measured_[i] = 0;
       hw_states_velocity_[i] = 0;
       hw_commands_[i] = 0;
     }
   }
 
+  executor_.start(node_);
+
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "System Successfully started!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -290,6 +379,8 @@ hardware_interface::CallbackReturn DiffDriveHardware::on_deactivate(const rclcpp
 {
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "Stopping ...please wait...");
 
+  executor_.stop();
+
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "System successfully stopped!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -41,7 +41,8 @@ using clearpath_hardware_interfaces::DiffDriveHardwareInterface;
  *
  */
 DiffDriveHardwareInterface::DiffDriveHardwareInterface(std::string node_name="diff_drive_hardware_interface")
-: Node(node_name)
+: Node(node_name),
+  feedback_sequence_(0)
 {
   feedback_sub_ = create_subscription<clearpath_platform_msgs::msg::Feedback>(
     "platform/motors/feedback",
@@ -54,45 +55,60 @@ DiffDriveHardwareInterface::DiffDriveHardwareInterface(std::string node_name="di
 }
 
 /**
- * @brief Feedback subscription callback
+ * @brief Feedback subscription callback, runs on the executor thread
  *
  * @param msg
  */
 void DiffDriveHardwareInterface::feedback_callback(const clearpath_platform_msgs::msg::Feedback::SharedPtr msg)
 {
-  std::lock_guard<std::mutex> guard(feedback_mutex_);
-  feedback_ = *msg;
+  DiffDriveFeedback & feedback = feedback_.back();
+  for (auto side = 0u; side < 2; side++)
+  {
+    feedback.measured_travel[side] = msg->drivers[side].measured_travel;
+    feedback.measured_velocity[side] = msg->drivers[side].measured_velocity;
+  }
+  feedback.sequence = ++feedback_sequence_;
+  feedback.stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  feedback_.publish();
 }
 
 /**
  * @brief Publish Drive message
  *
+ * Writes straight into middleware memory when the middleware can loan messages,
+ * otherwise reuses a preallocated message.
+ *
  * @param left_wheel Left wheel command
  * @param right_wheel Right wheel command
  * @param mode Command mode
  */
 void DiffDriveHardwareInterface::drive_command(const float & left_wheel, const float & right_wheel, const int8_t & mode)
 {
-  clearpath_platform_msgs::msg::Drive drive_msg;
-  drive_msg.mode = mode;
-  drive_msg.drivers[clearpath_platform_msgs::msg::Drive::LEFT] = left_wheel;
-  drive_msg.drivers[clearpath_platform_msgs::msg::Drive::RIGHT] = right_wheel;
-  drive_pub_->publish(drive_msg);
+  if (drive_pub_->can_loan_messages())
+  {
+    auto loaned_msg = drive_pub_->borrow_loaned_message();
+    auto & drive_msg = loaned_msg.get();
+    drive_msg.mode = mode;
+    drive_msg.drivers[clearpath_platform_msgs::msg::Drive::LEFT] = left_wheel;
+    drive_msg.drivers[clearpath_platform_msgs::msg::Drive::RIGHT] = right_wheel;
+    drive_pub_->publish(std::move(loaned_msg));
+    return;
+  }
+
+  drive_msg_.mode = mode;
+  drive_msg_.drivers[clearpath_platform_msgs::msg::Drive::LEFT] = left_wheel;
+  drive_msg_.drivers[clearpath_platform_msgs::msg::Drive::RIGHT] = right_wheel;
+  drive_pub_->publish(drive_msg_);
 }
 
 /**
- * @brief Get latest feedback message
+ * @brief Get latest feedback. Wait-free, safe to call from the realtime thread.
  *
- * @return clearpath_platform_msgs::msg::Feedback message
+ * @param feedback Filled with the latest feedback
+ * @return true if feedback arrived since the last call
  */
-clearpath_platform_msgs::msg::Feedback DiffDriveHardwareInterface::get_feedback()
+bool DiffDriveHardwareInterface::get_feedback(DiffDriveFeedback & feedback)
 {
-  clearpath_platform_msgs::msg::Feedback msg;
-
-  {
-    std::lock_guard<std::mutex> guard(feedback_mutex_);
-    msg = feedback_;
-  }
-
-  return msg;
+  return feedback_.read(feedback);
 }
@@ -0,0 +1,280 @@
+/**
+Software License Agreement (BSD)
+
+\file      direct_can.cpp
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+* Neither the name of Clearpath Robotics nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "clearpath_hardware_interfaces/puma/direct_can.hpp"
+
+#include "clearpath_motor_msgs/msg/puma_status.hpp"
+
+using clearpath_hardware_interfaces::PumaDirectCan;
+
+/**
+ * @brief Construct a new PumaDirectCan object
+ *
+ * @param node Node for the SocketCAN interface, spun by the plugin's executor thread
+ * @param config Settings shared by every driver
+ * @param joint_names Joint names, which are also the Puma device names
+ * @param can_ids CAN device number of each joint
+ * @param directions 1 or -1 for each joint
+*/
+PumaDirectCan::PumaDirectCan(
+  std::shared_ptr<rclcpp::Node> node, const Config & config,
+  const std::vector<std::string> & joint_names,
+  const std::vector<uint8_t> & can_ids,
+  const std::vector<int> & directions)
+: recv_msg_(new can_msgs::msg::Frame()),
+  sync_group_(config.sync_group),
+  feedback_timeout_(config.feedback_timeout),
+  active_(false)
+{
+  if (config.batch_tx)
+  {
+    tx_batch_ = std::make_shared<puma_motor_driver::CanTxBatch>(config.canbus_dev);
+    if (!tx_batch_->isOpen())
+    {
+      RCLCPP_WARN(
+        rclcpp::get_logger("puma_direct_can"),
+        "Batched transmit unavailable, using the send timer.");
+      tx_batch_.reset();
+    }
+  }
+
+  // Frames sent through the interface loop back to the raw socket as if the controllers had
+  // answered, so raw receive is only used together with batched transmit.
+  if (config.raw_rx && !tx_batch_)
+  {
+    RCLCPP_WARN(
+      rclcpp::get_logger("puma_direct_can"),
+      "Raw receive needs batch_tx, using the SocketCAN interface.");
+  }
+  else if (config.raw_rx)
+  {
+    rx_batch_ = std::make_unique<puma_motor_driver::CanRxBatch>(config.canbus_dev, can_ids);
+    if (!rx_batch_->isOpen())
+    {
+      RCLCPP_WARN(
+        rclcpp::get_logger("puma_direct_can"),
+        "Raw receive unavailable, using the SocketCAN interface.");
+      rx_batch_.reset();
+    }
+  }
+
+  // The SocketCAN interface is only needed when the raw sockets aren't both open.
+  if (!rx_batch_)
+  {
+    interface_.reset(new clearpath_ros2_socketcan_interface::SocketCANInterface(
+      config.canbus_dev, node));
+    interface_->startSendTimer(1);
+  }
+
+  for (auto i = 0u; i < joint_names.size(); i++)
+  {
+    drivers_.push_back(
+      puma_motor_driver::Driver(interface_, node, can_ids[i], joint_names[i], tx_batch_));
+  }
+
+  for (auto i = 0u; i < drivers_.size(); i++)
+  {
+    auto & driver = drivers_[i];
+    driver.clearMsgCache();
+    driver.setEncoderCPR(config.encoder_cpr);
+    driver.setGearRatio(config.gear_ratio * directions[i]);
+    driver.setMode(
+      clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED,
+      config.gain_p, config.gain_i, config.gain_d);
+    driver.setPeriodicStatus(config.periodic_status_ms);
+    driver.setPipelinedConfiguration(config.pipelined_configuration);
+    driver.setSyncGroup(config.sync_group);
+  }
+
+  device_drivers_.assign(drivers_);
+}
+
+/**
+ * @brief Process every frame received since the last call, and step driver configuration
+ * until all drivers are active. Mirrors MultiPumaNode::run().
+*/
+void PumaDirectCan::receive()
+{
+  // Process frames before configuring so that readbacks of the last burst are seen.
+  if (rx_batch_)
+  {
+    while (size_t count = rx_batch_->receive())
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        int64_t stamp = rx_batch_->frame(i, *recv_msg_);
+        device_drivers_.dispatch(recv_msg_, stamp);
+      }
+    }
+  }
+  else
+  {
+    while (interface_->recv(recv_msg_))
+    {
+      device_drivers_.dispatch(recv_msg_);
+    }
+  }
+
+  if (active_)
+  {
+    // Checks to see if power flag has been reset for each driver
+    for (auto & driver : drivers_)
+    {
+      if (driver.lastPower() != 0)
+      {
+        active_ = false;
+        RCLCPP_WARN(
+          rclcpp::get_logger("puma_direct_can"),
+          "Power reset detected on device ID %d, will reconfigure all drivers.",
+          driver.deviceNumber());
+        for (auto & reset_driver : drivers_)
+        {
+          reset_driver.resetConfiguration();
+        }
+        break;
+      }
+    }
+  }
+  else
+  {
+    for (auto & driver : drivers_)
+    {
+      driver.configureParams();
+    }
+  }
+
+  if (!active_)
+  {
+    bool all_configured = true;
+    for (auto & driver : drivers_)
+    {
+      driver.verifyParams();
+      all_configured &= driver.isConfigured();
+    }
+    if (all_configured)
+    {
+      active_ = true;
+      RCLCPP_INFO(rclcpp::get_logger("puma_direct_can"), "All controllers active.");
+    }
+  }
+  flush();
+}
+
+/**
+ * @brief Queue the requests whose responses the next receive() picks up. Drivers streaming
+ * periodic status send speed and travel on their own, so only their power flag is polled.
+*/
+void PumaDirectCan::requestFeedback()
+{
+  if (!active_)
+  {
+    return;
+  }
+
+  for (auto & driver : drivers_)
+  {
+    driver.requestStatusMessages();
+    if (!driver.periodicStatus())
+    {
+      driver.requestFeedbackPosition();
+      driver.requestFeedbackSpeed();
+    }
+  }
+  flush();
+}
+
+/**
+ * @brief Get the speed and travel of a joint, if both arrived since the last call and
+ * neither is older than the feedback timeout
+ *
+ * A speed or travel whose partner was lost waits for the next one; once both are in, the
+ * pair is consumed either way, so a stale half is dropped rather than reported alongside
+ * a fresh one.
+ *
+ * @param joint Joint index
+ * @param speed Set to the wheel speed in rad/s
+ * @param travel Set to the wheel travel in rad
+ * @return true if speed and travel were set
+*/
+bool PumaDirectCan::getFeedback(uint8_t joint, double & speed, double & travel)
+{
+  auto & driver = drivers_[joint];
+  if (!driver.receivedSpeed() || !driver.receivedPosition())
+  {
+    return false;
+  }
+  double age = driver.feedbackAge();
+  double last_speed = driver.lastSpeed();
+  double last_travel = driver.lastPosition();
+  if (age > feedback_timeout_)
+  {
+    return false;
+  }
+  speed = last_speed;
+  travel = last_travel;
+  return true;
+}
+
+/**
+ * @brief Queue a speed command for a joint, once all drivers are active
+ *
+ * @param joint Joint index
+ * @param velocity Wheel speed in rad/s
+*/
+void PumaDirectCan::command(uint8_t joint, double velocity)
+{
+  if (active_)
+  {
+    drivers_[joint].commandSpeed(velocity);
+  }
+}
+
+/**
+ * @brief Apply the speed commands staged since the last sync, if a sync group is set.
+ * Every joint then changes speed at the same instant rather than as each frame arrives.
+*/
+void PumaDirectCan::sync()
+{
+  if (active_ && sync_group_ && !drivers_.empty())
+  {
+    drivers_.front().sendSync(sync_group_);
+  }
+}
+
+/**
+ * @brief Send the frames queued since the last flush in one batch, if batching is enabled.
+ * Without it they drain on the SocketCAN interface's send timer.
+*/
+void PumaDirectCan::flush()
+{
+  if (tx_batch_)
+  {
+    tx_batch_->flush();
+  }
+}
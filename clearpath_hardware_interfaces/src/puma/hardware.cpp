@@ -37,7 +37,20 @@ namespace clearpath_hardware_interfaces
 */
 hardware_interface::CallbackReturn PumaHardware::initHardwareInterface()
 {
-  node_ = std::make_shared<PumaHardwareInterface>("puma_hardware_interface");
+  auto direct_it = info_.hardware_parameters.find("direct_can");
+  direct_can_ = direct_it != info_.hardware_parameters.end() && direct_it->second == "true";
+  if (direct_can_)
+  {
+    return initDirectCan();
+  }
+
+  std::vector<std::string> joint_names;
+  for (const auto & joint : info_.joints)
+  {
+    joint_names.push_back(joint.name);
+  }
+
+  node_ = std::make_shared<PumaHardwareInterface>("puma_hardware_interface", joint_names);
 
   if (node_ == nullptr)
   {
@@ -47,24 +60,90 @@ hardware_interface::CallbackReturn PumaHardware::initHardwareInterface()
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
+/**
+ * @brief Initialize direct CAN access, taking driver settings from the hardware parameters
+ * and the CAN device number and direction of each joint from its parameters
+*/
+hardware_interface::CallbackReturn PumaHardware::initDirectCan()
+{
+  auto param = [this](const std::string & name, const std::string & default_value)
+    {
+      auto it = info_.hardware_parameters.find(name);
+      return it != info_.hardware_parameters.end() ? it->second : default_value;
+    };
+
+  PumaDirectCan::Config config;
+  config.canbus_dev = param("canbus_dev", "vcan0");
+  config.encoder_cpr = std::stoi(param("encoder_cpr", "1024"));
+  config.gear_ratio = std::stod(param("gear_ratio", "24.0"));
+  config.gain_p = std::stod(param("gain_p", "0.1"));
+  config.gain_i = std::stod(param("gain_i", "0.01"));
+  config.gain_d = std::stod(param("gain_d", "0.0"));
+  config.batch_tx = param("batch_tx", "false") == "true";
+  config.periodic_status_ms = static_cast<uint16_t>(std::stoi(param("periodic_status", "0")));
+  config.pipelined_configuration = param("pipelined_configuration", "false") == "true";
+  config.sync_group = static_cast<uint8_t>(std::stoi(param("sync_group", "0")));
+  config.raw_rx = param("raw_rx", "false") == "true";
+  config.feedback_timeout = std::stod(param("feedback_timeout", "0.1"));
+
+  std::vector<std::string> joint_names;
+  std::vector<uint8_t> can_ids;
+  std::vector<int> directions;
+  for (const auto & joint : info_.joints)
+  {
+    auto can_id_it = joint.parameters.find("can_id");
+    if (can_id_it == joint.parameters.end())
+    {
+      RCLCPP_FATAL(
+        rclcpp::get_logger(hw_name_),
+        "Joint '%s' has no can_id parameter, which direct CAN mode requires.",
+        joint.name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+    auto direction_it = joint.parameters.find("direction");
+
+    joint_names.push_back(joint.name);
+    can_ids.push_back(static_cast<uint8_t>(std::stoi(can_id_it->second)));
+    directions.push_back(
+      direction_it != joint.parameters.end() ? std::stoi(direction_it->second) : 1);
+  }
+
+  RCLCPP_INFO(
+    rclcpp::get_logger(hw_name_), "Direct CAN mode on %s", config.canbus_dev.c_str());
+
+  can_node_ = std::make_shared<rclcpp::Node>("puma_direct_can");
+  can_ = std::make_unique<PumaDirectCan>(can_node_, config, joint_names, can_ids, directions);
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
 /**
  * @brief Write commands to the hardware
 */
 void PumaHardware::writeCommandsToHardware()
 {
-  sensor_msgs::msg::JointState joint_state;
-
-  for (const auto &it : wheel_joints_)
+  for (auto i = 0u; i < num_joints_; i++)
   {
-    joint_state.name.push_back(it.first);
-    double speed = hw_commands_[it.second];
+    double speed = hw_commands_[i];
     if (std::abs(speed) < MINIMUM_VELOCITY)
     {
       speed = 0.0;
     }
-    joint_state.velocity.push_back(speed);
+    cmd_msg_.velocity[i] = speed;
+  }
+
+  if (direct_can_)
+  {
+    for (auto i = 0u; i < num_joints_; i++)
+    {
+      can_->command(i, cmd_msg_.velocity[i]);
+    }
+    can_->sync();
+    can_->flush();
+    return;
   }
-  node_->drive_command(joint_state);
+
+  node_->drive_command(cmd_msg_);
   return;
 }
 
@@ -74,17 +153,25 @@ void PumaHardware::writeCommandsToHardware()
 */
 void PumaHardware::updateJointsFromHardware()
 {
-  rclcpp::spin_some(node_);
-
-  if (node_->has_new_feedback())
+  if (direct_can_)
   {
+    // Pick up responses to the previous cycle's requests, then request the next ones
+    can_->receive();
+    for (auto i = 0u; i < num_joints_; i++)
+    {
+      can_->getFeedback(i, hw_states_velocity_[i], hw_states_position_[i]);
+    }
+    can_->requestFeedback();
+    return;
+  }
 
-    auto msg = node_->get_feedback();
-
-    for (auto& puma : msg.drivers_feedback)
+  PumaJointFeedback msg;
+  if (node_->get_feedback(msg))
+  {
+    for (auto i = 0u; i < num_joints_; i++)
     {
-      hw_states_velocity_[wheel_joints_[puma.device_name]] = puma.speed;
-      hw_states_position_[wheel_joints_[puma.device_name]] = puma.travel; // * 0.049;
+      hw_states_velocity_[i] = msg.speed[i];
+      hw_states_position_[i] = msg.travel[i]; // * 0.049;
     }
   }
 }
@@ -180,6 +267,11 @@ hardware_interface::CallbackReturn PumaHardware::validateJoints()
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
+PumaHardware::~PumaHardware()
+{
+  executor_.stop();
+}
+
 /**
  * @brief Initialization
 */
@@ -237,10 +329,14 @@ std::vector<hardware_interface::CommandInterface> PumaHardware::export_command_i
     command_interfaces.emplace_back(
       hardware_interface::CommandInterface(
         info_.joints[i].name, hardware_interface::HW_IF_VELOCITY, &hw_commands_[i]));
+  }
 
-    // Map wheel joint name to index
-    wheel_joints_[info_.joints[i].name] = i;
+  cmd_msg_.name.clear();
+  for (auto i = 0u; i < num_joints_; i++)
+  {
+    cmd_msg_.name.push_back(info_.joints[i].name);
   }
+  cmd_msg_.velocity.assign(num_joints_, 0.0);
 
   return command_interfaces;
 }
@@ -264,6 +360,8 @@ hardware_interface::CallbackReturn PumaHardware::on_activate(const rclcpp_lifecy
     }
   }
 
+  executor_.start(direct_can_ ? can_node_ : node_);
+
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "System Successfully started!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -276,6 +374,8 @@ hardware_interface::CallbackReturn PumaHardware::on_deactivate(const rclcpp_life
 {
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "Stopping ...please wait...");
 
+  executor_.stop();
+
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "System successfully stopped!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
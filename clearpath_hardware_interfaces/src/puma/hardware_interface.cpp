@@ -29,14 +29,29 @@ POSSIBILITY OF SUCH DAMAGE.
 */
 #include "clearpath_hardware_interfaces/puma/hardware_interface.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
 using clearpath_hardware_interfaces::PumaHardwareInterface;
 
+static constexpr int8_t JOINT_UNRESOLVED = -2;
+static constexpr int8_t JOINT_UNKNOWN = -1;
+
 /**
  * @brief Construct a new PumaHardwareInterface object
+ *
+ * @param node_name
+ * @param joint_names Joint names, which are also the Puma device names
 */
-PumaHardwareInterface::PumaHardwareInterface(std::string node_name)
-: Node(node_name)
+PumaHardwareInterface::PumaHardwareInterface(
+  std::string node_name, const std::vector<std::string> & joint_names)
+: Node(node_name),
+  joint_names_(joint_names),
+  latest_feedback_()
 {
+  std::fill(std::begin(device_joints_), std::end(device_joints_), JOINT_UNRESOLVED);
+
   sub_feedback_ = create_subscription<clearpath_motor_msgs::msg::PumaMultiFeedback>(
     "platform/puma/feedback",
     rclcpp::SensorDataQoS(),
@@ -48,45 +63,79 @@ PumaHardwareInterface::PumaHardwareInterface(std::string node_name)
 }
 
 /**
- * @brief Callback for feedback
+ * @brief Callback for feedback, runs on the executor thread
  *
  * @param msg
 */
 void PumaHardwareInterface::feedback_callback(const clearpath_motor_msgs::msg::PumaMultiFeedback::SharedPtr msg)
 {
-  feedback_ = *msg;
-  has_feedback_ = true;
+  for (const auto & puma : msg->drivers_feedback)
+  {
+    int8_t joint = jointIndex(puma);
+    // Drivers without fresh feedback report NaN; keep their last good values.
+    if (joint < 0 || std::isnan(puma.speed) || std::isnan(puma.travel))
+    {
+      continue;
+    }
+    latest_feedback_.speed[joint] = puma.speed;
+    latest_feedback_.travel[joint] = puma.travel;
+  }
+  latest_feedback_.sequence++;
+  feedback_.write(latest_feedback_);
 }
 
 /**
- * @brief Publish drive command
+ * @brief Look up the joint a device reports for. Devices are matched to joints by name
+ * once, after which the lookup is by device number.
  *
- * @param
+ * @param puma Device feedback
+ * @return Joint index, or a negative value if the device is not one of the joints
 */
-void PumaHardwareInterface::drive_command(const sensor_msgs::msg::JointState msg)
+int8_t PumaHardwareInterface::jointIndex(const clearpath_motor_msgs::msg::PumaFeedback & puma)
 {
-  pub_cmd_->publish(msg);
-  return;
+  if (puma.device_number >= PUMA_MAX_DEVICES)
+  {
+    RCLCPP_WARN_ONCE(get_logger(), "Rejecting feedback from invalid device number");
+    return JOINT_UNKNOWN;
+  }
+
+  int8_t & joint = device_joints_[puma.device_number];
+  if (joint == JOINT_UNRESOLVED)
+  {
+    auto it = std::find(joint_names_.begin(), joint_names_.end(), puma.device_name);
+    if (it == joint_names_.end())
+    {
+      RCLCPP_WARN(
+        get_logger(), "Rejecting feedback from unknown device %u '%s'",
+        static_cast<unsigned>(puma.device_number), puma.device_name.c_str());
+      joint = JOINT_UNKNOWN;
+    }
+    else
+    {
+      joint = static_cast<int8_t>(it - joint_names_.begin());
+    }
+  }
+  return joint;
 }
 
 /**
- * @brief Check if there is new feedback
+ * @brief Publish drive command
  *
- * @return true
- * @return false
+ * @param
 */
-bool PumaHardwareInterface::has_new_feedback()
+void PumaHardwareInterface::drive_command(const sensor_msgs::msg::JointState & msg)
 {
-  return has_feedback_;
+  pub_cmd_->publish(msg);
+  return;
 }
 
 /**
- * @brief Get feedback
+ * @brief Get latest feedback. Wait-free, safe to call from the realtime thread.
  *
- * @return clearpath_motor_msgs::msg::PumaMultiFeedback
+ * @param feedback Filled with the latest feedback
+ * @return true if feedback arrived since the last call
 */
-clearpath_motor_msgs::msg::PumaMultiFeedback PumaHardwareInterface::get_feedback()
+bool PumaHardwareInterface::get_feedback(PumaJointFeedback & feedback)
 {
-  has_feedback_ = false;
-  return feedback_;
+  return feedback_.read(feedback);
 }
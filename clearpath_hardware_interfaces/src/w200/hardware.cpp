@@ -36,6 +36,8 @@
 #include "clearpath_platform_msgs/msg/feedback.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 
+#include <limits>
+
 namespace clearpath_hardware_interfaces
 {
 
@@ -46,10 +48,28 @@ static const std::string RIGHT_ALT_JOINT_NAME = "rear_right_wheel_joint";
 
 static constexpr double MINIMUM_VELOCITY = 0.01f;
 
+static const std::string FEEDBACK_AGE_INTERFACE = "feedback_age";
+
+static constexpr uint8_t LEFT = 0;
+static constexpr uint8_t RIGHT = 1;
+
 
 hardware_interface::CallbackReturn W200Hardware::initHardwareInterface()
 {
-  node_ = std::make_shared<W200HardwareInterface>("w200_hardware_interface");
+  // Left and right feedback further apart than this are not paired, unless they drift apart
+  // for several samples or for longer than feedback_timeout
+  auto skew_it = info_.hardware_parameters.find("feedback_skew");
+  double feedback_skew =
+    skew_it != info_.hardware_parameters.end() ? std::stod(skew_it->second) : 0.01;
+
+  // Feedback older than feedback_timeout is reported as stale. Optionally extrapolate
+  // position to the control loop time from the measured velocity.
+  auto timeout_it = info_.hardware_parameters.find("feedback_timeout");
+  feedback_timeout_ =
+    timeout_it != info_.hardware_parameters.end() ? std::stod(timeout_it->second) : 0.1;
+
+  node_ = std::make_shared<W200HardwareInterface>(
+    "w200_hardware_interface", feedback_skew, feedback_timeout_);
 
   if (node_ == nullptr)
   {
@@ -65,8 +85,8 @@ hardware_interface::CallbackReturn W200Hardware::initHardwareInterface()
  */
 void W200Hardware::writeCommandsToHardware()
 {
-  double diff_speed_left = hw_commands_[wheel_joints_[LEFT_CMD_JOINT_NAME]];
-  double diff_speed_right = hw_commands_[wheel_joints_[RIGHT_CMD_JOINT_NAME]];
+  double diff_speed_left = hw_commands_[wheel_joints_.left_cmd];
+  double diff_speed_right = hw_commands_[wheel_joints_.right_cmd];
 
   if (std::abs(diff_speed_left) < MINIMUM_VELOCITY
     && std::abs(diff_speed_right) < MINIMUM_VELOCITY)
@@ -84,28 +104,126 @@ void W200Hardware::writeCommandsToHardware()
  * and store in joint structure for ros_control
  *
  */
-void W200Hardware::updateJointsFromHardware(const rclcpp::Duration & period)
+void W200Hardware::updateJointsFromHardware()
 {
-  rclcpp::spin_some(node_);
-
-  if (node_->has_new_feedback())
+  W200Feedback msg;
+  while (node_->get_feedback(msg))
   {
-    auto left_msg = node_->get_left_feedback();
-    auto right_msg = node_->get_right_feedback();
     RCLCPP_DEBUG(
       rclcpp::get_logger(hw_name_),
       "Received linear distance information (L: %f, R: %f)",
-      left_msg.data, right_msg.data);
+      msg.velocity[LEFT], msg.velocity[RIGHT]);
+    integrateFeedback(msg);
+  }
 
-    hw_states_velocity_[wheel_joints_[LEFT_CMD_JOINT_NAME]] = left_msg.data;
-    hw_states_velocity_[wheel_joints_[RIGHT_CMD_JOINT_NAME]] = right_msg.data;
-    hw_states_velocity_[wheel_joints_[LEFT_ALT_JOINT_NAME]] = left_msg.data;
-    hw_states_velocity_[wheel_joints_[RIGHT_ALT_JOINT_NAME]] = right_msg.data;
+  if (feedback_stamp_ == 0)
+  {
+    // No feedback yet
+    feedback_age_ = std::numeric_limits<double>::infinity();
+    return;
+  }
 
-    hw_states_position_[wheel_joints_[LEFT_CMD_JOINT_NAME]] += left_msg.data * period.seconds();
-    hw_states_position_[wheel_joints_[RIGHT_CMD_JOINT_NAME]] += right_msg.data * period.seconds();
-    hw_states_position_[wheel_joints_[LEFT_ALT_JOINT_NAME]] += left_msg.data * period.seconds();
-    hw_states_position_[wheel_joints_[RIGHT_ALT_JOINT_NAME]] += right_msg.data * period.seconds();
+  auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  feedback_age_ = (now - feedback_stamp_) * 1e-9;
+  checkFeedbackAge();
+
+  // Optionally project position forward to now using the measured velocity. Once the
+  // feedback is stale, which feedback_age exceeding feedback_timeout reports, the velocity can
+  // no longer be trusted and the measured position is exported as is.
+  double extrapolation = 0.0;
+  if (feedback_extrapolation_ && !feedback_stale_)
+  {
+    extrapolation = feedback_age_;
+  }
+
+  for (auto i = 0u; i < num_joints_; i++)
+  {
+    hw_states_position_[i] = hw_states_position_measured_[i] +
+      hw_states_velocity_[i] * extrapolation;
+  }
+}
+
+/**
+ * @brief Advance each joint's travel to a feedback pair and take its velocity.
+ * Integrates with the trapezoidal rule over the time between feedback samples, rather than
+ * the control period, so that cycles without feedback neither gain nor lose travel.
+ * A gap longer than feedback_timeout is skipped: its velocity is stale, so nothing is
+ * integrated across it and the new sample starts the integration afresh. Neither is travel
+ * integrated up to a forced pair, whose sides were measured too far apart to share a stamp.
+ *
+ * @param feedback Left and right velocity pair
+ */
+void W200Hardware::integrateFeedback(const W200Feedback & feedback)
+{
+  double dt = 0.0;
+  if (feedback_stamp_ != 0 && !feedback.forced)
+  {
+    dt = std::max((feedback.stamp - feedback_stamp_) * 1e-9, 0.0);
+    if (dt > feedback_timeout_)
+    {
+      dt = 0.0;
+    }
+  }
+  feedback_stamp_ = feedback.stamp;
+
+  for (auto i = 0u; i < num_joints_; i++)
+  {
+    double velocity = feedback.velocity[wheel_joints_.side[i]];
+    hw_states_position_measured_[i] += 0.5 * (hw_states_velocity_[i] + velocity) * dt;
+    hw_states_velocity_[i] = velocity;
+  }
+}
+
+/**
+ * @brief Log when feedback goes stale, or resumes after going stale
+ *
+ */
+void W200Hardware::checkFeedbackAge()
+{
+  bool stale = feedback_age_ > feedback_timeout_;
+  if (stale && !feedback_stale_)
+  {
+    RCLCPP_WARN(
+      rclcpp::get_logger(hw_name_), "Feedback is stale, last received %.3f s ago",
+      feedback_age_);
+  }
+  else if (!stale && feedback_stale_)
+  {
+    RCLCPP_INFO(rclcpp::get_logger(hw_name_), "Feedback resumed");
+  }
+  feedback_stale_ = stale;
+}
+
+/**
+ * @brief Resolve command joint indices and the drive side of every joint,
+ * so that read() and write() never look joints up by name
+ *
+ */
+void W200Hardware::resolveWheelJoints()
+{
+  wheel_joints_.left_cmd = 0;
+  wheel_joints_.right_cmd = 0;
+  for (auto i = 0u; i < num_joints_; i++)
+  {
+    const std::string & name = info_.joints[i].name;
+    if (name == LEFT_CMD_JOINT_NAME)
+    {
+      wheel_joints_.left_cmd = i;
+    }
+    else if (name == RIGHT_CMD_JOINT_NAME)
+    {
+      wheel_joints_.right_cmd = i;
+    }
+
+    if (name == RIGHT_CMD_JOINT_NAME || name == RIGHT_ALT_JOINT_NAME)
+    {
+      wheel_joints_.side[i] = RIGHT;
+    }
+    else
+    {
+      wheel_joints_.side[i] = LEFT;
+    }
   }
 }
 
@@ -133,9 +251,17 @@ hardware_interface::CallbackReturn W200Hardware::getHardwareInfo(const hardware_
 
   hw_states_position_.resize(num_joints_);
   hw_states_position_offset_.resize(num_joints_);
+  hw_states_position_measured_.resize(num_joints_);
   hw_states_velocity_.resize(num_joints_);
   hw_commands_.resize(num_joints_);
 
+  auto extrapolation_it = info_.hardware_parameters.find("feedback_extrapolation");
+  feedback_extrapolation_ =
+    extrapolation_it != info_.hardware_parameters.end() && extrapolation_it->second == "true";
+  feedback_age_ = std::numeric_limits<double>::infinity();
+  feedback_stale_ = false;
+  feedback_stamp_ = 0;
+
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
@@ -196,6 +322,11 @@ hardware_interface::CallbackReturn W200Hardware::validateJoints()
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
+W200Hardware::~W200Hardware()
+{
+  executor_.stop();
+}
+
 hardware_interface::CallbackReturn W200Hardware::on_init(const hardware_interface::HardwareInfo & info)
 {
   hardware_interface::CallbackReturn ret;
@@ -232,6 +363,9 @@ std::vector<hardware_interface::StateInterface> W200Hardware::export_state_inter
         info_.joints[i].name, hardware_interface::HW_IF_VELOCITY, &hw_states_velocity_[i]));
   }
 
+  state_interfaces.emplace_back(
+    hardware_interface::StateInterface(hw_name_, FEEDBACK_AGE_INTERFACE, &feedback_age_));
+
   return state_interfaces;
 }
 
@@ -245,10 +379,10 @@ std::vector<hardware_interface::CommandInterface> W200Hardware::export_command_i
       hardware_interface::CommandInterface(
         info_.joints[i].name, hardware_interface::HW_IF_VELOCITY, &hw_commands_[i]));
 
-    // Map wheel joint name to index
-    wheel_joints_[info_.joints[i].name] = i;
   }
 
+  resolveWheelJoints();
+
   return command_interfaces;
 }
 
@@ -263,11 +397,14 @@ hardware_interface::CallbackReturn W200Hardware::on_activate(const rclcpp_lifecy
     {
       hw_states_position_[i] = 0;
       hw_states_position_offset_[i] = 0;
+      hw_states_position_measured_[i] = 0;
       hw_states_velocity_[i] = 0;
       hw_commands_[i] = 0;
     }
   }
 
+  executor_.start(node_);
+
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "System Successfully started!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -277,6 +414,8 @@ hardware_interface::CallbackReturn W200Hardware::on_deactivate(const rclcpp_life
 {
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "Stopping ...please wait...");
 
+  executor_.stop();
+
   RCLCPP_INFO(rclcpp::get_logger(hw_name_), "System successfully stopped!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -288,7 +427,7 @@ hardware_interface::return_type W200Hardware::read(const rclcpp::Time & /*time*/
 
   RCLCPP_DEBUG(rclcpp::get_logger(hw_name_), "Duration %f", period.seconds());
 
-  updateJointsFromHardware(period);
+  updateJointsFromHardware();
 
   RCLCPP_DEBUG(rclcpp::get_logger(hw_name_), "Joints successfully read!");
 
@@ -34,14 +34,26 @@
 
 #include "clearpath_hardware_interfaces/w200/hardware_interface.hpp"
 
+#include <cinttypes>
+
 using clearpath_hardware_interfaces::W200HardwareInterface;
 
 /**
  * @brief Construct a new W200HardwareInterface object
  *
  */
-W200HardwareInterface::W200HardwareInterface(std::string node_name)
-: Node(node_name)
+W200HardwareInterface::W200HardwareInterface(
+  std::string node_name, double max_feedback_skew, double feedback_timeout)
+: Node(node_name),
+  samples_(),
+  max_feedback_skew_(static_cast<int64_t>(max_feedback_skew * 1e9)),
+  feedback_timeout_(static_cast<int64_t>(feedback_timeout * 1e9)),
+  last_pair_stamp_(0),
+  feedback_sequence_(0),
+  unpaired_samples_(0),
+  consecutive_unpaired_(0),
+  forced_pairs_(0),
+  dropped_feedback_(0)
 {
   sub_left_feedback_ = create_subscription<std_msgs::msg::Float64>(
     "platform/motor/left/status/velocity",
@@ -69,8 +81,7 @@ W200HardwareInterface::W200HardwareInterface(std::string node_name)
  */
 void W200HardwareInterface::feedback_left_callback(const std_msgs::msg::Float64::SharedPtr msg)
 {
-  feedback_left_ = *msg;
-  has_left_feedback_ = true;
+  feedback_callback(0, msg->data);
 }
 
 /**
@@ -80,55 +91,123 @@ void W200HardwareInterface::feedback_left_callback(const std_msgs::msg::Float64:
  */
 void W200HardwareInterface::feedback_right_callback(const std_msgs::msg::Float64::SharedPtr msg)
 {
-  feedback_right_ = *msg;
-  has_right_feedback_ = true;
+  feedback_callback(1, msg->data);
 }
 
 /**
- * @brief Publish Drive message
+ * @brief Pair a wheel velocity with the latest sample from the other side.
+ * A pair is published once both sides have arrived within max_feedback_skew of each other;
+ * a sample with no partner inside the window is replaced by the next one from its side.
+ * Should the sides drift apart for longer, the latest sample of each is paired anyway so
+ * that the velocities keep updating. Such pairs are marked as forced.
  *
- * @param left_wheel Left wheel command
- * @param right_wheel Right wheel command
- * @param mode Command mode
+ * @param side 0 for left, 1 for right
+ * @param velocity Wheel velocity
  */
-void W200HardwareInterface::drive_command(const float & left_wheel, const float & right_wheel)
+void W200HardwareInterface::feedback_callback(uint8_t side, double velocity)
 {
-  std_msgs::msg::Float64 msg_left_cmd, msg_right_cmd;
-  msg_left_cmd.data = left_wheel;
-  msg_right_cmd.data = right_wheel;
-  pub_left_cmd->publish(msg_left_cmd);
-  pub_right_cmd->publish(msg_right_cmd);
+  auto stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  Sample & sample = samples_[side];
+  Sample & other = samples_[1 - side];
+  if (sample.valid)
+  {
+    // Previous sample from this side never found a partner
+    unpaired_samples_++;
+    consecutive_unpaired_++;
+    RCLCPP_DEBUG(
+      get_logger(), "Dropped unpaired feedback sample, %" PRIu64 " so far",
+      unpaired_samples_);
+  }
+  sample.velocity = velocity;
+  sample.stamp = stamp;
+  sample.valid = true;
+
+  if (!other.valid)
+  {
+    return;
+  }
+  bool forced = stamp - other.stamp > max_feedback_skew_;
+  if (forced)
+  {
+    bool timed_out = last_pair_stamp_ != 0 && stamp - last_pair_stamp_ > feedback_timeout_;
+    if (consecutive_unpaired_ < MAX_UNPAIRED_SAMPLES && !timed_out)
+    {
+      return;
+    }
+    forced_pairs_++;
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 1000,
+      "Left and right feedback more than %.3f s apart, pairing latest samples (%" PRIu64
+      " so far)", max_feedback_skew_ * 1e-9, forced_pairs_);
+  }
+
+  W200Feedback feedback;
+  feedback.velocity[side] = sample.velocity;
+  feedback.velocity[1 - side] = other.velocity;
+  feedback.stamp = other.stamp;
+  feedback.forced = forced;
+  feedback.sequence = ++feedback_sequence_;
+  if (!feedback_.push(feedback))
+  {
+    dropped_feedback_++;
+    RCLCPP_DEBUG(
+      get_logger(), "Feedback queue full, %" PRIu64 " pairs dropped so far",
+      dropped_feedback_);
+  }
+
+  sample.valid = false;
+  other.valid = false;
+  consecutive_unpaired_ = 0;
+  last_pair_stamp_ = stamp;
 }
 
 /**
- * @brief Check if there is new feedback on both left and right side
+ * @brief Publish Drive message
  *
- * @return true
- * @return false
+ * @param left_wheel Left wheel command
+ * @param right_wheel Right wheel command
+ * @param mode Command mode
  */
-bool W200HardwareInterface::has_new_feedback()
+void W200HardwareInterface::drive_command(const float & left_wheel, const float & right_wheel)
 {
-  return (has_left_feedback_ && has_right_feedback_);
+  publish_command(pub_left_cmd, msg_left_cmd_, left_wheel);
+  publish_command(pub_right_cmd, msg_right_cmd_, right_wheel);
 }
 
 /**
- * @brief Get the left side feedback
+ * @brief Publish a wheel command, in a loaned message if the middleware supports it,
+ * otherwise in the preallocated message
  *
- * @return std_msgs::msg::Float64
+ * @param pub Wheel command publisher
+ * @param msg Preallocated message for pub
+ * @param value Wheel command
  */
-std_msgs::msg::Float64 W200HardwareInterface::get_left_feedback()
+void W200HardwareInterface::publish_command(
+  rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr & pub,
+  std_msgs::msg::Float64 & msg, const double & value)
 {
-  has_left_feedback_ = false;
-  return feedback_left_;
+  if (pub->can_loan_messages())
+  {
+    auto loaned_msg = pub->borrow_loaned_message();
+    loaned_msg.get().data = value;
+    pub->publish(std::move(loaned_msg));
+    return;
+  }
+
+  msg.data = value;
+  pub->publish(msg);
 }
 
 /**
- * @brief Get the right side feedback
+ * @brief Take the oldest left and right feedback pair not yet read. Wait-free, safe to call
+ * from the realtime thread.
  *
- * @return std_msgs::msg::Float64
+ * @param feedback Filled with the pair
+ * @return false if there are no unread pairs
  */
-std_msgs::msg::Float64 W200HardwareInterface::get_right_feedback()
+bool W200HardwareInterface::get_feedback(W200Feedback & feedback)
 {
-  has_right_feedback_ = false;
-  return feedback_right_;
+  return feedback_.pop(feedback);
 }
@@ -0,0 +1,218 @@
+/**
+Software License Agreement (BSD)
+\file      test_puma_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CLEARPATH_HARDWARE_INTERFACES__FAKE_MCU_HPP_
+#define CLEARPATH_HARDWARE_INTERFACES__FAKE_MCU_HPP_
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Message.h"
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Transport.h"
+
+/**
+ * Plays the A200 MCU on the far end of a pseudo terminal. Messages from the transport are
+ * read and answered one by one from the test, or, once serve() is called, by a thread that
+ * acks every command and request and answers each request with the data set for it.
+ */
+class FakeMcu
+{
+public:
+  FakeMcu()
+  : master_(-1), slave_(-1), serving_(false)
+  {
+    char name[128];
+    if (openpty(&master_, &slave_, name, nullptr, nullptr) == 0)
+    {
+      fcntl(master_, F_SETFL, fcntl(master_, F_GETFL) | O_NONBLOCK);
+      port_ = name;
+    }
+  }
+
+  ~FakeMcu()
+  {
+    stop();
+    if (master_ >= 0)
+    {
+      close(master_);
+      close(slave_);
+    }
+  }
+
+  const std::string & port() const
+  {
+    return port_;
+  }
+
+  /**
+   * Read up to count messages written by the transport, for up to timeout seconds.
+   * The transport only writes when polled, so it is polled while waiting.
+   */
+  std::vector<clearpath::Message> receive(size_t count, double timeout = 0.5)
+  {
+    std::vector<clearpath::Message> messages;
+    auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(timeout));
+    while (messages.size() < count && std::chrono::steady_clock::now() < deadline)
+    {
+      clearpath::Transport::instance().poll();
+      read(messages);
+      usleep(500);
+    }
+    return messages;
+  }
+
+  void send(uint16_t type, std::vector<uint8_t> payload = {})
+  {
+    clearpath::Message msg(type, payload.data(), payload.size());
+    uint8_t buf[clearpath::Message::MAX_MSG_LENGTH];
+    size_t length = msg.toBytes(buf, sizeof(buf));
+    if (::write(master_, buf, length) != static_cast<ssize_t>(length))
+    {
+      perror("FakeMcu write");
+    }
+  }
+
+  void ack(uint16_t type, uint16_t result = 0)
+  {
+    send(type, {static_cast<uint8_t>(result & 0xff), static_cast<uint8_t>(result >> 8)});
+  }
+
+  // Payload served in reply to requests for a data type
+  void setData(uint16_t type, const std::vector<uint8_t> & payload)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_[type] = payload;
+  }
+
+  // Messages of a type the serving thread has received
+  size_t received(uint16_t type)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return received_[type];
+  }
+
+  void serve()
+  {
+    serving_ = true;
+    thread_ = std::thread([this]()
+      {
+        std::vector<clearpath::Message> messages;
+        struct pollfd fd = {master_, POLLIN, 0};
+        while (serving_)
+        {
+          if (::poll(&fd, 1, 10) <= 0)
+          {
+            continue;
+          }
+          messages.clear();
+          read(messages);
+          for (auto & msg : messages)
+          {
+            answer(msg);
+          }
+        }
+      });
+  }
+
+  void stop()
+  {
+    serving_ = false;
+    if (thread_.joinable())
+    {
+      thread_.join();
+    }
+  }
+
+private:
+  void answer(clearpath::Message & msg)
+  {
+    uint16_t type = msg.getType();
+    std::vector<uint8_t> payload;
+    bool reply = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      received_[type]++;
+      // Requests are answered with the matching data type
+      auto data = data_.find(type + 0x4000);
+      if (msg.isRequest() && data != data_.end())
+      {
+        payload = data->second;
+        reply = true;
+      }
+    }
+    ack(type);
+    if (reply)
+    {
+      send(type + 0x4000, payload);
+    }
+  }
+
+  // Parse whatever the transport has written so far
+  void read(std::vector<clearpath::Message> & messages)
+  {
+    uint8_t buf[256];
+    ssize_t length;
+    while ((length = ::read(master_, buf, sizeof(buf))) > 0)
+    {
+      rx_.insert(rx_.end(), buf, buf + length);
+    }
+
+    while (!rx_.empty())
+    {
+      if (rx_[0] != clearpath::Message::SOH)
+      {
+        rx_.erase(rx_.begin());
+        continue;
+      }
+      if (rx_.size() < 3 || rx_.size() < static_cast<size_t>(rx_[1]) + 3)
+      {
+        break;
+      }
+      size_t total = rx_[1] + 3;
+      messages.emplace_back(rx_.data(), total);
+      rx_.erase(rx_.begin(), rx_.begin() + total);
+    }
+  }
+
+  int master_, slave_;
+  std::string port_;
+  std::vector<uint8_t> rx_;
+
+  std::atomic<bool> serving_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::map<uint16_t, std::vector<uint8_t>> data_;
+  std::map<uint16_t, size_t> received_;
+};
+
+#endif  // CLEARPATH_HARDWARE_INTERFACES__FAKE_MCU_HPP_
@@ -0,0 +1,176 @@
+/**
+Software License Agreement (BSD)
+\file      test_puma_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/a200/hardware.hpp"
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Message.h"
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Transport.h"
+
+#include "fake_mcu.hpp"
+
+using clearpath_hardware_interfaces::A200Hardware;
+
+// Wheel speeds in rad/s; with a 0.3 m wheel, 0.005 rad/s is 0.00075 m/s, inside the default
+// command_tolerance of 0.001 m/s, and 0.01 rad/s is 0.0015 m/s, outside it
+static const double SPEED = 1.0;
+static const double INSIDE_TOLERANCE = 0.005;
+static const double OUTSIDE_TOLERANCE = 0.01;
+
+class A200HardwareTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    ASSERT_FALSE(mcu_.port().empty());
+    // Encoder data for two wheels, read once at startup for the travel offset
+    mcu_.setData(clearpath::DATA_ENCODER, {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+    mcu_.serve();
+  }
+
+  void TearDown() override
+  {
+    clearpath::Transport::instance().close();
+  }
+
+  hardware_interface::HardwareInfo hardwareInfo() const
+  {
+    hardware_interface::HardwareInfo info;
+    info.name = "a200_hardware";
+    info.hardware_parameters["serial_port"] = mcu_.port();
+    info.hardware_parameters["wheel_diameter"] = "0.3";
+    info.hardware_parameters["max_accel"] = "3.0";
+    info.hardware_parameters["max_speed"] = "1.0";
+    info.hardware_parameters["polling_timeout"] = "0.1";
+    for (const auto & name : {"front_left_wheel_joint", "front_right_wheel_joint"})
+    {
+      hardware_interface::ComponentInfo joint;
+      joint.name = name;
+      hardware_interface::InterfaceInfo interface;
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.command_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_POSITION;
+      joint.state_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.state_interfaces.push_back(interface);
+      info.joints.push_back(joint);
+    }
+    return info;
+  }
+
+  // Bring the hardware up and keep its command interfaces
+  void start(const hardware_interface::HardwareInfo & info)
+  {
+    ASSERT_EQ(hardware_.on_init(info), hardware_interface::CallbackReturn::SUCCESS);
+    commands_ = hardware_.export_command_interfaces();
+    ASSERT_EQ(commands_.size(), 2u);
+    ASSERT_EQ(
+      hardware_.on_activate(rclcpp_lifecycle::State()),
+      hardware_interface::CallbackReturn::SUCCESS);
+  }
+
+  // Command both wheels and write, returning the wheel commands the MCU has received in all
+  size_t write(double speed)
+  {
+    for (auto & command : commands_)
+    {
+      command.set_value(speed);
+    }
+    hardware_.write(rclcpp::Time(), rclcpp::Duration(0, 0));
+    return mcu_.received(clearpath::SET_DIFF_WHEEL_SPEEDS);
+  }
+
+  FakeMcu mcu_;
+  A200Hardware hardware_;
+  std::vector<hardware_interface::CommandInterface> commands_;
+};
+
+TEST_F(A200HardwareTest, EveryCommandIsSentByDefault)
+{
+  start(hardwareInfo());
+  EXPECT_EQ(write(SPEED), 1u);
+  EXPECT_EQ(write(SPEED), 2u);
+  EXPECT_EQ(write(SPEED), 3u);
+}
+
+TEST_F(A200HardwareTest, CommandWithinToleranceIsSuppressed)
+{
+  auto info = hardwareInfo();
+  info.hardware_parameters["command_suppression"] = "true";
+  start(info);
+
+  EXPECT_EQ(write(SPEED), 1u);
+  EXPECT_EQ(write(SPEED), 1u);
+  EXPECT_EQ(write(SPEED + INSIDE_TOLERANCE), 1u);
+  EXPECT_EQ(write(SPEED + OUTSIDE_TOLERANCE), 2u);
+}
+
+TEST_F(A200HardwareTest, FirstCommandAfterActivationIsSent)
+{
+  auto info = hardwareInfo();
+  info.hardware_parameters["command_suppression"] = "true";
+  start(info);
+
+  EXPECT_EQ(write(SPEED), 1u);
+  ASSERT_EQ(
+    hardware_.on_activate(rclcpp_lifecycle::State()),
+    hardware_interface::CallbackReturn::SUCCESS);
+  EXPECT_EQ(write(SPEED), 2u);
+}
+
+// An unchanged command is repeated every mcu_command_timeout * keepalive_fraction, here
+// every 0.1 s, so 0.35 s of writes at 100 Hz send it at 0, 0.1, 0.2 and 0.3 s
+TEST_F(A200HardwareTest, UnchangedCommandIsKeptAlive)
+{
+  auto info = hardwareInfo();
+  info.hardware_parameters["command_suppression"] = "true";
+  info.hardware_parameters["mcu_command_timeout"] = "0.2";
+  info.hardware_parameters["keepalive_fraction"] = "0.5";
+  start(info);
+
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(350);
+  size_t sent = 0;
+  while (std::chrono::steady_clock::now() < end)
+  {
+    sent = write(SPEED);
+    usleep(10000);
+  }
+  EXPECT_GE(sent, 3u);
+  EXPECT_LE(sent, 4u);
+}
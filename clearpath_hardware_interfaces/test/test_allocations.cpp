@@ -0,0 +1,321 @@
+/**
+Software License Agreement (BSD)
+\file      test_allocations.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/joint_state.hpp"
+#include "std_msgs/msg/float64.hpp"
+
+#include "clearpath_hardware_interfaces/diff_drive/hardware_interface.hpp"
+#include "clearpath_hardware_interfaces/puma/hardware.hpp"
+#include "clearpath_hardware_interfaces/sample_queue.hpp"
+#include "clearpath_hardware_interfaces/triple_buffer.hpp"
+#include "clearpath_hardware_interfaces/w200/hardware_interface.hpp"
+
+// Count every allocation made through operator new. The array and sized forms
+// forward to these by default.
+static std::atomic<size_t> allocations(0);
+
+void * operator new(std::size_t size)
+{
+  allocations++;
+  void * p = std::malloc(size ? size : 1);
+  if (p == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void * p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+using clearpath_hardware_interfaces::DiffDriveHardwareInterface;
+using clearpath_hardware_interfaces::PumaHardware;
+using clearpath_hardware_interfaces::PumaJointFeedback;
+using clearpath_hardware_interfaces::SampleQueue;
+using clearpath_hardware_interfaces::TripleBuffer;
+using clearpath_hardware_interfaces::W200HardwareInterface;
+
+static constexpr int CYCLES = 1000;
+
+// Allocations made by CYCLES calls to f, after a few warm up calls
+template<typename F>
+size_t countAllocations(F f)
+{
+  for (int i = 0; i < 10; i++)
+  {
+    f();
+  }
+  size_t start = allocations;
+  for (int i = 0; i < CYCLES; i++)
+  {
+    f();
+  }
+  return allocations - start;
+}
+
+TEST(TripleBuffer, HandoffDoesNotAllocate)
+{
+  TripleBuffer<PumaJointFeedback> buffer;
+  PumaJointFeedback in{}, out{};
+
+  size_t start = allocations;
+  for (int i = 0; i < CYCLES; i++)
+  {
+    in.sequence = i + 1;
+    buffer.write(in);
+    ASSERT_TRUE(buffer.read(out));
+    ASSERT_FALSE(buffer.read(out));
+  }
+  EXPECT_EQ(allocations - start, 0u);
+  EXPECT_EQ(out.sequence, static_cast<uint64_t>(CYCLES));
+}
+
+TEST(TripleBuffer, ReadsLatestValue)
+{
+  TripleBuffer<int> buffer;
+  int value = -1;
+  EXPECT_FALSE(buffer.read(value));
+  EXPECT_EQ(value, 0);
+
+  buffer.write(1);
+  buffer.write(2);
+  buffer.back() = 3;
+  buffer.publish();
+  EXPECT_TRUE(buffer.read(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(buffer.read(value));
+  EXPECT_EQ(value, 3);
+}
+
+TEST(SampleQueue, PushAndPopDoNotAllocate)
+{
+  SampleQueue<PumaJointFeedback, 8> queue;
+  PumaJointFeedback in{}, out{};
+
+  size_t start = allocations;
+  for (int i = 0; i < CYCLES; i++)
+  {
+    in.sequence = i + 1;
+    ASSERT_TRUE(queue.push(in));
+    ASSERT_TRUE(queue.pop(out));
+    ASSERT_FALSE(queue.pop(out));
+  }
+  EXPECT_EQ(allocations - start, 0u);
+  EXPECT_EQ(out.sequence, static_cast<uint64_t>(CYCLES));
+}
+
+TEST(SampleQueue, DeliversInOrderAndDropsWhenFull)
+{
+  SampleQueue<int, 4> queue;
+  for (int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(queue.push(i));
+  }
+  EXPECT_FALSE(queue.push(4));
+
+  int value;
+  for (int i = 0; i < 4; i++)
+  {
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.pop(value));
+}
+
+// The middleware may allocate in publish(); the command paths must not add to that. Each
+// is compared against publishing the same message with the same QoS on a bare publisher.
+class PublishTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  template<typename MessageT>
+  static size_t baselineAllocations(const MessageT & msg)
+  {
+    auto node = std::make_shared<rclcpp::Node>("allocation_baseline");
+    auto publisher = node->create_publisher<MessageT>(
+      "allocation_baseline/cmd", rclcpp::SensorDataQoS());
+    return countAllocations([&]() {publisher->publish(msg);});
+  }
+
+  // Publish until a message arrives on topic, for up to a second
+  template<typename MessageT, typename F>
+  static bool deliver(
+    const rclcpp::Node::SharedPtr & node, const std::string & topic, F publish,
+    MessageT & received)
+  {
+    bool delivered = false;
+    auto subscription = node->create_subscription<MessageT>(
+      topic, rclcpp::SensorDataQoS(),
+      [&](const std::shared_ptr<MessageT> msg)
+      {
+        received = *msg;
+        delivered = true;
+      });
+    for (int i = 0; i < 100 && !delivered; i++)
+    {
+      publish();
+      rclcpp::spin_some(node);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return delivered;
+  }
+};
+
+TEST_F(PublishTest, DiffDriveCommandAllocatesNoMoreThanPublish)
+{
+  auto node = std::make_shared<DiffDriveHardwareInterface>("diff_drive_hardware_interface");
+
+  clearpath_platform_msgs::msg::Drive msg;
+  msg.mode = clearpath_platform_msgs::msg::Drive::MODE_VELOCITY;
+  msg.drivers[clearpath_platform_msgs::msg::Drive::LEFT] = 1.0;
+  msg.drivers[clearpath_platform_msgs::msg::Drive::RIGHT] = -1.0;
+  size_t baseline = baselineAllocations(msg);
+
+  EXPECT_LE(
+    countAllocations(
+      [&]() {node->drive_command(1.0, -1.0, clearpath_platform_msgs::msg::Drive::MODE_VELOCITY);}),
+    baseline);
+
+  clearpath_platform_msgs::msg::Drive received;
+  ASSERT_TRUE(
+    deliver(
+      node, "platform/motors/cmd_drive",
+      [&]() {node->drive_command(0.5, -0.25, clearpath_platform_msgs::msg::Drive::MODE_VELOCITY);},
+      received));
+  EXPECT_EQ(received.mode, clearpath_platform_msgs::msg::Drive::MODE_VELOCITY);
+  EXPECT_EQ(received.drivers[clearpath_platform_msgs::msg::Drive::LEFT], 0.5);
+  EXPECT_EQ(received.drivers[clearpath_platform_msgs::msg::Drive::RIGHT], -0.25);
+}
+
+TEST_F(PublishTest, W200CommandAllocatesNoMoreThanPublish)
+{
+  auto node = std::make_shared<W200HardwareInterface>("w200_hardware_interface");
+
+  std_msgs::msg::Float64 msg;
+  msg.data = 1.0;
+  // One message per wheel
+  size_t baseline = 2 * baselineAllocations(msg);
+
+  EXPECT_LE(countAllocations([&]() {node->drive_command(1.0, -1.0);}), baseline);
+
+  std_msgs::msg::Float64 left, right;
+  ASSERT_TRUE(
+    deliver(
+      node, "platform/motor/left/cmd_velocity", [&]() {node->drive_command(0.5, -0.25);}, left));
+  ASSERT_TRUE(
+    deliver(
+      node, "platform/motor/right/cmd_velocity", [&]() {node->drive_command(0.5, -0.25);}, right));
+  EXPECT_EQ(left.data, 0.5);
+  EXPECT_EQ(right.data, -0.25);
+}
+
+// Exposes the command path of PumaHardware
+class TestPumaHardware : public PumaHardware
+{
+public:
+  using PumaHardware::writeCommandsToHardware;
+
+  std::vector<double> & commands()
+  {
+    return hw_commands_;
+  }
+
+  const sensor_msgs::msg::JointState & commandMessage() const
+  {
+    return cmd_msg_;
+  }
+};
+
+class PumaCommandTest : public PublishTest
+{
+protected:
+  static hardware_interface::HardwareInfo hardwareInfo()
+  {
+    hardware_interface::HardwareInfo info;
+    info.name = "puma_hardware";
+    for (const char * name : {"front_left_wheel_joint", "front_right_wheel_joint",
+        "rear_left_wheel_joint", "rear_right_wheel_joint"})
+    {
+      hardware_interface::ComponentInfo joint;
+      joint.name = name;
+      hardware_interface::InterfaceInfo interface;
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.command_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_POSITION;
+      joint.state_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.state_interfaces.push_back(interface);
+      info.joints.push_back(joint);
+    }
+    return info;
+  }
+};
+
+TEST_F(PumaCommandTest, WriteAllocatesNoMoreThanPublish)
+{
+  TestPumaHardware hardware;
+  ASSERT_EQ(hardware.on_init(hardwareInfo()), hardware_interface::CallbackReturn::SUCCESS);
+  auto command_interfaces = hardware.export_command_interfaces();
+  ASSERT_EQ(command_interfaces.size(), 4u);
+
+  const double * velocity = hardware.commandMessage().velocity.data();
+  const std::string * name = hardware.commandMessage().name.data();
+  hardware.commands() = {0.5, -0.5, 0.005, -1.0};
+
+  hardware.writeCommandsToHardware();
+  size_t baseline = baselineAllocations(hardware.commandMessage());
+  EXPECT_LE(countAllocations([&]() {hardware.writeCommandsToHardware();}), baseline);
+
+  // Velocities are written in place, below MINIMUM_VELOCITY clamped to zero
+  EXPECT_EQ(hardware.commandMessage().velocity.data(), velocity);
+  EXPECT_EQ(hardware.commandMessage().name.data(), name);
+  EXPECT_EQ(hardware.commandMessage().name[0], "front_left_wheel_joint");
+  EXPECT_EQ(hardware.commandMessage().velocity, std::vector<double>({0.5, -0.5, 0.0, -1.0}));
+}
@@ -0,0 +1,242 @@
+/**
+Software License Agreement (BSD)
+\file      test_diff_drive_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/diff_drive/hardware.hpp"
+
+using clearpath_hardware_interfaces::DiffDriveHardware;
+using clearpath_platform_msgs::msg::Drive;
+using clearpath_platform_msgs::msg::Feedback;
+
+// Exposes the joint state and commands of DiffDriveHardware
+class TestDiffDriveHardware : public DiffDriveHardware
+{
+public:
+  std::vector<double> & commands()
+  {
+    return hw_commands_;
+  }
+
+  const std::vector<double> & positions() const
+  {
+    return hw_states_position_;
+  }
+
+  const std::vector<double> & velocities() const
+  {
+    return hw_states_velocity_;
+  }
+};
+
+class DiffDriveHardwareTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    node_ = std::make_shared<rclcpp::Node>("diff_drive_hardware_test");
+    feedback_pub_ = node_->create_publisher<Feedback>(
+      "platform/motors/feedback", rclcpp::SensorDataQoS());
+    drive_sub_ = node_->create_subscription<Drive>(
+      "platform/motors/cmd_drive", rclcpp::SensorDataQoS(),
+      [this](const Drive::SharedPtr msg) {drive_ = msg;});
+  }
+
+  static hardware_interface::HardwareInfo hardwareInfo(const std::vector<std::string> & joints)
+  {
+    hardware_interface::HardwareInfo info;
+    info.name = "diff_drive_hardware";
+    for (const auto & name : joints)
+    {
+      hardware_interface::ComponentInfo joint;
+      joint.name = name;
+      hardware_interface::InterfaceInfo interface;
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.command_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_POSITION;
+      joint.state_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.state_interfaces.push_back(interface);
+      info.joints.push_back(joint);
+    }
+    return info;
+  }
+
+  // Initialize and activate hardware, which starts spinning its node
+  static void start(TestDiffDriveHardware & hardware, const std::vector<std::string> & joints)
+  {
+    ASSERT_EQ(hardware.on_init(hardwareInfo(joints)), hardware_interface::CallbackReturn::SUCCESS);
+    ASSERT_EQ(hardware.export_command_interfaces().size(), joints.size());
+    ASSERT_EQ(
+      hardware.on_activate(rclcpp_lifecycle::State()),
+      hardware_interface::CallbackReturn::SUCCESS);
+  }
+
+  // Write until a drive command arrives, for up to a second
+  bool write(TestDiffDriveHardware & hardware)
+  {
+    drive_.reset();
+    for (int i = 0; i < 100 && !drive_; i++)
+    {
+      hardware.write(rclcpp::Time(0), rclcpp::Duration(0, 0));
+      rclcpp::spin_some(node_);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return drive_ != nullptr;
+  }
+
+  // Publish feedback and read until it reaches the joint velocities, for up to a second
+  bool read(TestDiffDriveHardware & hardware, const double left_travel, const double right_travel)
+  {
+    Feedback msg;
+    msg.drivers[Drive::LEFT].measured_travel = left_travel;
+    msg.drivers[Drive::LEFT].measured_velocity = LEFT_VELOCITY;
+    msg.drivers[Drive::RIGHT].measured_travel = right_travel;
+    msg.drivers[Drive::RIGHT].measured_velocity = RIGHT_VELOCITY;
+    for (int i = 0; i < 100; i++)
+    {
+      feedback_pub_->publish(msg);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      hardware.read(rclcpp::Time(0), rclcpp::Duration(0, 0));
+      if (hardware.velocities()[0] != 0.0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static constexpr double LEFT_VELOCITY = 1.5;
+  static constexpr double RIGHT_VELOCITY = -2.0;
+
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::Publisher<Feedback>::SharedPtr feedback_pub_;
+  rclcpp::Subscription<Drive>::SharedPtr drive_sub_;
+  Drive::SharedPtr drive_;
+};
+
+// Joints are listed out of order. The drive command must still take the front wheel commands.
+TEST_F(DiffDriveHardwareTest, WriteTakesFrontWheelCommands)
+{
+  TestDiffDriveHardware hardware;
+  start(
+    hardware,
+    {"rear_right_wheel_joint", "front_right_wheel_joint", "rear_left_wheel_joint",
+      "front_left_wheel_joint"});
+  hardware.commands() = {9.0, -0.5, 9.0, 0.25};
+
+  ASSERT_TRUE(write(hardware));
+  EXPECT_EQ(drive_->mode, Drive::MODE_VELOCITY);
+  EXPECT_FLOAT_EQ(drive_->drivers[Drive::LEFT], 0.25);
+  EXPECT_FLOAT_EQ(drive_->drivers[Drive::RIGHT], -0.5);
+  hardware.on_deactivate(rclcpp_lifecycle::State());
+}
+
+TEST_F(DiffDriveHardwareTest, WriteTakesTwoJointCommands)
+{
+  TestDiffDriveHardware hardware;
+  start(hardware, {"front_right_wheel_joint", "front_left_wheel_joint"});
+  hardware.commands() = {-0.5, 0.25};
+
+  ASSERT_TRUE(write(hardware));
+  EXPECT_FLOAT_EQ(drive_->drivers[Drive::LEFT], 0.25);
+  EXPECT_FLOAT_EQ(drive_->drivers[Drive::RIGHT], -0.5);
+  hardware.on_deactivate(rclcpp_lifecycle::State());
+}
+
+// Every joint takes the travel and velocity of its own drive side
+TEST_F(DiffDriveHardwareTest, ReadMapsFeedbackToDriveSides)
+{
+  TestDiffDriveHardware hardware;
+  start(
+    hardware,
+    {"rear_right_wheel_joint", "front_right_wheel_joint", "rear_left_wheel_joint",
+      "front_left_wheel_joint"});
+
+  ASSERT_TRUE(read(hardware, 0.25, 0.5));
+  EXPECT_EQ(hardware.positions(), std::vector<double>({0.5, 0.5, 0.25, 0.25}));
+  EXPECT_EQ(
+    hardware.velocities(),
+    std::vector<double>({RIGHT_VELOCITY, RIGHT_VELOCITY, LEFT_VELOCITY, LEFT_VELOCITY}));
+  hardware.on_deactivate(rclcpp_lifecycle::State());
+}
+
+// read() only takes the latest sample from the executor thread. Its latency must stay flat
+// while feedback callbacks run concurrently.
+TEST_F(DiffDriveHardwareTest, ReadLatencyWhileSpinning)
+{
+  TestDiffDriveHardware hardware;
+  start(hardware, {"front_left_wheel_joint", "front_right_wheel_joint"});
+
+  std::atomic<bool> publishing(true);
+  std::thread publisher([this, &publishing]()
+    {
+      Feedback msg;
+      while (publishing)
+      {
+        feedback_pub_->publish(msg);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+
+  constexpr int READS = 2000;
+  std::vector<int64_t> latency;
+  latency.reserve(READS);
+  for (int i = 0; i < READS; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    hardware.read(rclcpp::Time(0), rclcpp::Duration(0, 0));
+    latency.push_back(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+  publishing = false;
+  publisher.join();
+  hardware.on_deactivate(rclcpp_lifecycle::State());
+
+  std::sort(latency.begin(), latency.end());
+  int64_t median = latency[READS / 2];
+  int64_t p99 = latency[READS * 99 / 100];
+  RecordProperty("read_median_ns", std::to_string(median));
+  RecordProperty("read_p99_ns", std::to_string(p99));
+  EXPECT_LT(p99, 1000000) << "median " << median << " ns";
+}
@@ -0,0 +1,119 @@
+/**
+Software License Agreement (BSD)
+\file      test_executor_thread.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/executor_thread.hpp"
+
+using clearpath_hardware_interfaces::ExecutorThread;
+
+class ExecutorThreadTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    ticks_ = 0;
+    node_ = std::make_shared<rclcpp::Node>("executor_thread_test");
+    timer_ = node_->create_wall_timer(
+      std::chrono::milliseconds(5), [this]() {ticks_++;});
+  }
+
+  // Wait up to a second for the node's timer to fire
+  bool waitForTick()
+  {
+    unsigned int start = ticks_;
+    for (int i = 0; i < 200 && ticks_ == start; i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return ticks_ != start;
+  }
+
+  std::atomic_uint ticks_;
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+TEST_F(ExecutorThreadTest, SpinsNodeUntilStopped)
+{
+  ExecutorThread executor;
+  EXPECT_FALSE(executor.running());
+
+  executor.start(node_);
+  EXPECT_TRUE(executor.running());
+  EXPECT_TRUE(waitForTick());
+
+  executor.stop();
+  EXPECT_FALSE(executor.running());
+  unsigned int stopped = ticks_;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(ticks_, stopped);
+}
+
+TEST_F(ExecutorThreadTest, RestartsAfterStop)
+{
+  ExecutorThread executor;
+  executor.start(node_);
+  executor.stop();
+
+  // The node must have been released by the first executor to be added to the second
+  executor.start(node_);
+  EXPECT_TRUE(waitForTick());
+}
+
+TEST_F(ExecutorThreadTest, StopIsIdempotent)
+{
+  ExecutorThread executor;
+  executor.stop();
+  executor.start(node_);
+  executor.stop();
+  executor.stop();
+  EXPECT_FALSE(executor.running());
+}
+
+TEST_F(ExecutorThreadTest, DestructorStops)
+{
+  {
+    ExecutorThread executor;
+    executor.start(node_);
+    EXPECT_TRUE(waitForTick());
+  }
+  unsigned int stopped = ticks_;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(ticks_, stopped);
+}
@@ -0,0 +1,337 @@
+/**
+Software License Agreement (BSD)
+\file      test_puma_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Message.h"
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Message_request.h"
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Number.h"
+#include "clearpath_hardware_interfaces/a200/horizon_legacy/Transport.h"
+
+#include "fake_mcu.hpp"
+
+using clearpath::Message;
+using clearpath::Request;
+using clearpath::Transport;
+
+// Request types the transport has no special handling for, with their data reply types
+static const uint16_t REQUEST_A = 0x4fe0, DATA_A = 0x8fe0;
+static const uint16_t REQUEST_B = 0x4fe1, DATA_B = 0x8fe1;
+static const uint16_t REQUEST_C = 0x4fe2;
+
+// Transport::MIN_LATENCY_SAMPLES
+static const int MIN_LATENCY_SAMPLES = 20;
+
+class HorizonTransportTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_FALSE(mcu_.port().empty());
+    transport().configure(mcu_.port().c_str(), 3);
+  }
+
+  void TearDown() override
+  {
+    transport().setAdaptiveTimeout(false, 0.0);
+    transport().setAckTypeFallback(false);
+    transport().close();
+  }
+
+  static Transport & transport()
+  {
+    return Transport::instance();
+  }
+
+  // Wait for a request to finish and return the first payload byte of its reply
+  static int replyByte(Transport::RequestId id)
+  {
+    Message * reply = nullptr;
+    EXPECT_EQ(transport().wait(id, &reply), Transport::REQUEST_COMPLETE);
+    if (!reply)
+    {
+      return -1;
+    }
+    uint8_t payload[8] = {0};
+    reply->getPayload(payload, sizeof(payload));
+    delete reply;
+    return payload[0];
+  }
+
+  // Complete one REQUEST_B, answered delay seconds after it is written out
+  void roundTrip(double delay = 0.0)
+  {
+    Request b(REQUEST_B);
+    Transport::RequestId id = transport().issue(&b, 1.0, DATA_B);
+    ASSERT_EQ(mcu_.receive(1).size(), 1u);
+    usleep(static_cast<useconds_t>(delay * 1e6));
+    mcu_.ack(REQUEST_B);
+    mcu_.send(DATA_B, {0});
+    EXPECT_EQ(transport().wait(id), Transport::REQUEST_COMPLETE);
+  }
+
+  // Poll the transport for a while, so that whatever the MCU sent is dispatched
+  static void settle()
+  {
+    for (int i = 0; i < 20; i++)
+    {
+      transport().poll();
+      usleep(1000);
+    }
+  }
+
+  FakeMcu mcu_;
+};
+
+TEST_F(HorizonTransportTest, RepliesOutOfOrderReachTheirRequests)
+{
+  Request a(REQUEST_A), b(REQUEST_B);
+  Transport::RequestId id_a = transport().issue(&a, 1.0, DATA_A);
+  Transport::RequestId id_b = transport().issue(&b, 1.0, DATA_B);
+  EXPECT_NE(id_a, id_b);
+  ASSERT_EQ(mcu_.receive(2).size(), 2u);
+
+  // B is answered first
+  mcu_.ack(REQUEST_B);
+  mcu_.send(DATA_B, {2});
+  mcu_.ack(REQUEST_A);
+  mcu_.send(DATA_A, {1});
+
+  EXPECT_EQ(replyByte(id_b), 2);
+  EXPECT_EQ(replyByte(id_a), 1);
+  EXPECT_EQ(transport().pendingRequests(), 0u);
+}
+
+TEST_F(HorizonTransportTest, RepliesOfOneTypeGoToTheOldestRequest)
+{
+  Request first(REQUEST_A), second(REQUEST_A);
+  Transport::RequestId id_first = transport().issue(&first, 1.0, DATA_A);
+  Transport::RequestId id_second = transport().issue(&second, 1.0, DATA_A);
+  ASSERT_EQ(mcu_.receive(2).size(), 2u);
+
+  mcu_.ack(REQUEST_A);
+  mcu_.send(DATA_A, {1});
+  mcu_.ack(REQUEST_A);
+  mcu_.send(DATA_A, {2});
+
+  // Collected newest first, which must not change which reply each one gets
+  EXPECT_EQ(replyByte(id_second), 2);
+  EXPECT_EQ(replyByte(id_first), 1);
+}
+
+TEST_F(HorizonTransportTest, UnansweredRequestExpiresAtItsDeadline)
+{
+  Request a(REQUEST_A);
+  auto start = std::chrono::steady_clock::now();
+  Transport::RequestId id = transport().issue(&a, 0.05, DATA_A);
+
+  EXPECT_EQ(transport().wait(id), Transport::REQUEST_TIMEOUT);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_GE(elapsed, 0.05);
+  EXPECT_LT(elapsed, 0.15);
+  EXPECT_EQ(transport().getCounter(Transport::EXPIRED_REQUEST), 1u);
+
+  // Collected requests are forgotten
+  EXPECT_EQ(transport().collect(id), Transport::REQUEST_UNKNOWN);
+}
+
+TEST_F(HorizonTransportTest, AckedRequestStillWaitsForItsReply)
+{
+  Request a(REQUEST_A);
+  Transport::RequestId id = transport().issue(&a, 0.1, DATA_A);
+  ASSERT_EQ(mcu_.receive(1).size(), 1u);
+
+  mcu_.ack(REQUEST_A);
+  EXPECT_EQ(transport().wait(id), Transport::REQUEST_TIMEOUT);
+}
+
+TEST_F(HorizonTransportTest, RejectedRequestReportsItsResultCode)
+{
+  Request a(REQUEST_A);
+  Transport::RequestId id = transport().issue(&a, 1.0);
+  ASSERT_EQ(mcu_.receive(1).size(), 1u);
+
+  mcu_.ack(REQUEST_A, 0x08);
+  unsigned int result_code = 0;
+  EXPECT_EQ(transport().wait(id, nullptr, &result_code), Transport::REQUEST_REJECTED);
+  EXPECT_EQ(result_code, 0x08u);
+}
+
+TEST_F(HorizonTransportTest, LatencyNeedsMinimumSamples)
+{
+  for (int i = 0; i < MIN_LATENCY_SAMPLES - 1; i++)
+  {
+    roundTrip();
+  }
+  EXPECT_EQ(transport().getLatency(DATA_B), 0.0);
+
+  roundTrip();
+  EXPECT_GT(transport().getLatency(DATA_B), 0.0);
+}
+
+// The 99th percentile of up to 128 samples is the slowest but one, so one slow round
+// trip does not move it and a second one does
+TEST_F(HorizonTransportTest, LatencyIsThe99thPercentileOfTheWindow)
+{
+  for (int i = 0; i < MIN_LATENCY_SAMPLES; i++)
+  {
+    roundTrip();
+  }
+  double fast = transport().getLatency(DATA_B);
+  ASSERT_LT(fast, 0.02);
+
+  roundTrip(0.05);
+  EXPECT_LT(transport().getLatency(DATA_B), 0.02);
+
+  roundTrip(0.05);
+  EXPECT_GE(transport().getLatency(DATA_B), 0.05);
+}
+
+TEST_F(HorizonTransportTest, AdaptiveDeadlineFollowsMeasuredLatency)
+{
+  for (int i = 0; i < MIN_LATENCY_SAMPLES; i++)
+  {
+    roundTrip();
+  }
+  transport().setAdaptiveTimeout(true, 0.01);
+
+  // Unanswered, it expires at the measured latency plus the margin rather than after 1 s
+  Request b(REQUEST_B);
+  auto start = std::chrono::steady_clock::now();
+  Transport::RequestId id = transport().issue(&b, 1.0, DATA_B);
+  EXPECT_EQ(transport().getCounter(Transport::ADAPTIVE_DEADLINE), 1u);
+  EXPECT_EQ(transport().wait(id), Transport::REQUEST_TIMEOUT);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_LT(elapsed, 0.1);
+  EXPECT_EQ(transport().getCounter(Transport::STALL_AVOIDED), 1u);
+}
+
+TEST_F(HorizonTransportTest, LateAckDoesNotCompleteAnotherRequest)
+{
+  Request a(REQUEST_A);
+  EXPECT_EQ(transport().wait(transport().issue(&a, 0.05)), Transport::REQUEST_TIMEOUT);
+  Request b(REQUEST_B);
+  Transport::RequestId id = transport().issue(&b, 1.0);
+  ASSERT_EQ(mcu_.receive(2).size(), 2u);
+
+  // A's ack turns up after its deadline, while B is waiting
+  mcu_.ack(REQUEST_A);
+  settle();
+  EXPECT_EQ(transport().status(id), Transport::REQUEST_PENDING);
+  EXPECT_EQ(transport().getCounter(Transport::LATE_ACK), 1u);
+
+  // Only one ack was owed
+  mcu_.ack(REQUEST_A);
+  settle();
+  EXPECT_EQ(transport().getCounter(Transport::IGNORED_ACK), 1u);
+
+  mcu_.ack(REQUEST_B);
+  EXPECT_EQ(transport().wait(id), Transport::REQUEST_COMPLETE);
+}
+
+TEST_F(HorizonTransportTest, UnsentRequestOwesNoAck)
+{
+  // A holds the link while B expires in the queue behind it
+  Request a(REQUEST_A), b(REQUEST_B);
+  Transport::RequestId id_a = transport().issue(&a, 1.0);
+  Transport::RequestId id_b = transport().issue(&b, 0.0001);
+  usleep(5000);
+  EXPECT_EQ(transport().collect(id_b), Transport::REQUEST_TIMEOUT);
+
+  std::vector<Message> sent = mcu_.receive(2, 0.05);
+  ASSERT_EQ(sent.size(), 1u);
+  EXPECT_EQ(sent[0].getType(), REQUEST_A);
+  mcu_.ack(REQUEST_A);
+  EXPECT_EQ(transport().wait(id_a), Transport::REQUEST_COMPLETE);
+
+  // An ack of B's type can only be a stray
+  mcu_.ack(REQUEST_B);
+  settle();
+  EXPECT_EQ(transport().getCounter(Transport::LATE_ACK), 0u);
+  EXPECT_EQ(transport().getCounter(Transport::IGNORED_ACK), 1u);
+}
+
+TEST_F(HorizonTransportTest, AckTypeFallbackIsOffByDefault)
+{
+  Request b(REQUEST_B);
+  Transport::RequestId id = transport().issue(&b, 1.0);
+  ASSERT_EQ(mcu_.receive(1).size(), 1u);
+
+  mcu_.ack(REQUEST_C);
+  settle();
+  EXPECT_EQ(transport().status(id), Transport::REQUEST_PENDING);
+  EXPECT_EQ(transport().getCounter(Transport::IGNORED_ACK), 1u);
+}
+
+TEST_F(HorizonTransportTest, AckTypeFallbackCompletesTheOnlyWaitingRequest)
+{
+  transport().setAckTypeFallback(true);
+  Request b(REQUEST_B);
+  Transport::RequestId id = transport().issue(&b, 1.0);
+  ASSERT_EQ(mcu_.receive(1).size(), 1u);
+
+  mcu_.ack(REQUEST_C);
+  EXPECT_EQ(transport().wait(id), Transport::REQUEST_COMPLETE);
+}
+
+TEST_F(HorizonTransportTest, AckTypeFallbackNeedsASingleWaitingRequest)
+{
+  transport().setAckTypeFallback(true);
+  Request a(REQUEST_A), b(REQUEST_B);
+  Transport::RequestId id_a = transport().issue(&a, 1.0);
+  Transport::RequestId id_b = transport().issue(&b, 1.0);
+  ASSERT_EQ(mcu_.receive(2).size(), 2u);
+
+  mcu_.ack(REQUEST_C);
+  settle();
+  EXPECT_EQ(transport().status(id_a), Transport::REQUEST_PENDING);
+  EXPECT_EQ(transport().status(id_b), Transport::REQUEST_PENDING);
+  EXPECT_EQ(transport().getCounter(Transport::IGNORED_ACK), 1u);
+}
+
+// While one frame is on the wire, the queue behind it drains commands first, then
+// feedback requests, then configuration, then status
+TEST_F(HorizonTransportTest, QueuedTrafficIsSentInPriorityOrder)
+{
+  uint8_t payload[4] = {0};
+  Message blocker(clearpath::SET_MAX_ACCEL, payload, 4);
+  Request status(clearpath::REQUEST_SYSTEM_STATUS);
+  Message config(clearpath::SET_MAX_SPEED, payload, 4);
+  Request data(REQUEST_A);
+  Message command(clearpath::SET_DIFF_WHEEL_SPEEDS, payload, 4);
+
+  transport().issue(&blocker, 1.0);
+  transport().issue(&status, 1.0);
+  transport().issue(&config, 1.0);
+  transport().issue(&data, 1.0);
+  transport().issue(&command, 1.0);
+
+  std::vector<Message> sent = mcu_.receive(5);
+  ASSERT_EQ(sent.size(), 5u);
+  EXPECT_EQ(sent[0].getType(), clearpath::SET_MAX_ACCEL);
+  EXPECT_EQ(sent[1].getType(), clearpath::SET_DIFF_WHEEL_SPEEDS);
+  EXPECT_EQ(sent[2].getType(), REQUEST_A);
+  EXPECT_EQ(sent[3].getType(), clearpath::SET_MAX_SPEED);
+  EXPECT_EQ(sent[4].getType(), clearpath::REQUEST_SYSTEM_STATUS);
+}
@@ -0,0 +1,344 @@
+/**
+Software License Agreement (BSD)
+\file      test_puma_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/puma/hardware.hpp"
+#include "clearpath_motor_msgs/msg/puma_status.hpp"
+#include "puma_motor_driver/can_proto.hpp"
+
+using clearpath_hardware_interfaces::PumaHardware;
+using clearpath_motor_msgs::msg::PumaStatus;
+
+// These tests need a virtual CAN interface:
+//   ip link add dev vcan0 type vcan && ip link set up vcan0
+static const char * const CANBUS_DEV = "vcan0";
+
+static constexpr double GEAR_RATIO = 24.0;
+
+// Plays every Puma controller on a CAN bus: stores what is set, answers what is requested
+// and reports the speed each device number was last commanded.
+class FakePumaBus
+{
+public:
+  FakePumaBus()
+  : running_(true)
+  {
+    socket_ = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    struct sockaddr_can addr = {};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = if_nametoindex(CANBUS_DEV);
+    if (socket_ >= 0 && bind(socket_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+      close(socket_);
+      socket_ = -1;
+    }
+    if (socket_ >= 0)
+    {
+      thread_ = std::thread(&FakePumaBus::run, this);
+    }
+  }
+
+  ~FakePumaBus()
+  {
+    running_ = false;
+    if (thread_.joinable())
+    {
+      thread_.join();
+    }
+    if (socket_ >= 0)
+    {
+      close(socket_);
+    }
+  }
+
+  bool isOpen() const
+  {
+    return socket_ >= 0;
+  }
+
+  // Speed in RPM and travel in revolutions the device reports when asked
+  void setFeedback(uint8_t device_number, double rpm, double revs)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device & device = devices_[device_number];
+    device.registers[LM_API_STATUS_SPD] = fixed16x16(rpm);
+    device.registers[LM_API_STATUS_POS] = fixed16x16(revs);
+  }
+
+  // Last speed set-point sent to the device, in RPM
+  double commandedRpm(uint8_t device_number)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t value;
+    std::memcpy(&value, devices_[device_number].registers[LM_API_SPD_SET].data(), sizeof(value));
+    return value / 65536.0;
+  }
+
+private:
+  struct Device
+  {
+    std::map<uint32_t, std::array<uint8_t, 8>> registers;
+    uint8_t mode = PumaStatus::MODE_VOLTAGE;
+    uint8_t power = 1;
+  };
+
+  static std::array<uint8_t, 8> fixed16x16(double value)
+  {
+    std::array<uint8_t, 8> data{};
+    int32_t fixed = static_cast<int32_t>(value * 65536);
+    std::memcpy(data.data(), &fixed, sizeof(fixed));
+    return data;
+  }
+
+  void run()
+  {
+    struct pollfd fd = {socket_, POLLIN, 0};
+    while (running_)
+    {
+      struct can_frame frame;
+      if (poll(&fd, 1, 10) > 0 && ::read(socket_, &frame, sizeof(frame)) == sizeof(frame))
+      {
+        handle(frame);
+      }
+    }
+  }
+
+  void handle(struct can_frame frame)
+  {
+    if (!(frame.can_id & CAN_EFF_FLAG))
+    {
+      return;
+    }
+    uint32_t id = frame.can_id & CAN_EFF_MASK;
+    uint32_t api = id & ~CAN_MSGID_DEVNO_M;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device & device = devices_[id & CAN_MSGID_DEVNO_M];
+    if (api == LM_API_SPD_EN)
+    {
+      device.mode = PumaStatus::MODE_SPEED;
+      return;
+    }
+    if (api == LM_API_VOLT_EN)
+    {
+      device.mode = PumaStatus::MODE_VOLTAGE;
+      return;
+    }
+    if (frame.can_dlc)
+    {
+      // Setting the power flag clears it
+      if (api == LM_API_STATUS_POWER)
+      {
+        device.power = 0;
+      }
+      else
+      {
+        std::copy(frame.data, frame.data + 8, device.registers[api].begin());
+      }
+      return;
+    }
+
+    // A request, answered on the same id
+    frame.can_dlc = 8;
+    if (api == LM_API_STATUS_POWER)
+    {
+      std::memset(frame.data, 0, sizeof(frame.data));
+      frame.data[0] = device.power;
+    }
+    else if (api == LM_API_STATUS_CMODE)
+    {
+      std::memset(frame.data, 0, sizeof(frame.data));
+      frame.data[0] = device.mode;
+    }
+    else
+    {
+      std::copy(device.registers[api].begin(), device.registers[api].end(), frame.data);
+    }
+    if (::write(socket_, &frame, sizeof(frame)) != sizeof(frame))
+    {
+      ADD_FAILURE() << "Fake Puma failed to answer: " << strerror(errno);
+    }
+  }
+
+  int socket_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::map<uint8_t, Device> devices_;
+};
+
+// Exposes the joint state and commands of PumaHardware
+class TestPumaHardware : public PumaHardware
+{
+public:
+  std::vector<double> & commands()
+  {
+    return hw_commands_;
+  }
+
+  const std::vector<double> & positions() const
+  {
+    return hw_states_position_;
+  }
+
+  const std::vector<double> & velocities() const
+  {
+    return hw_states_velocity_;
+  }
+};
+
+// The left joint is device 5 and the right joint device 3, turning the other way, so that
+// neither joint order nor device order gives the right answer by accident.
+class PumaDirectCanTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    if (if_nametoindex(CANBUS_DEV) == 0)
+    {
+      GTEST_SKIP() << CANBUS_DEV << " is not available";
+    }
+    ASSERT_TRUE(bus_.isOpen());
+
+    hardware_interface::HardwareInfo info;
+    info.name = "puma_hardware";
+    info.hardware_parameters["direct_can"] = "true";
+    info.hardware_parameters["canbus_dev"] = CANBUS_DEV;
+    info.hardware_parameters["gear_ratio"] = std::to_string(GEAR_RATIO);
+    for (const auto & name : {"left_wheel_joint", "right_wheel_joint"})
+    {
+      hardware_interface::ComponentInfo joint;
+      joint.name = name;
+      hardware_interface::InterfaceInfo interface;
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.command_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_POSITION;
+      joint.state_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.state_interfaces.push_back(interface);
+      info.joints.push_back(joint);
+    }
+    info.joints[0].parameters["can_id"] = "5";
+    info.joints[1].parameters["can_id"] = "3";
+    info.joints[1].parameters["direction"] = "-1";
+
+    ASSERT_EQ(hardware_.on_init(info), hardware_interface::CallbackReturn::SUCCESS);
+    ASSERT_EQ(hardware_.export_command_interfaces().size(), 2u);
+    ASSERT_EQ(hardware_.export_state_interfaces().size(), 4u);
+    ASSERT_EQ(
+      hardware_.on_activate(rclcpp_lifecycle::State()),
+      hardware_interface::CallbackReturn::SUCCESS);
+  }
+
+  void TearDown() override
+  {
+    if (IsSkipped())
+    {
+      return;
+    }
+    hardware_.on_deactivate(rclcpp_lifecycle::State());
+  }
+
+  // Run control cycles at 100 Hz until done() holds, for up to five seconds
+  template<typename Predicate>
+  bool cycle(Predicate done)
+  {
+    for (int i = 0; i < 500; i++)
+    {
+      hardware_.read(rclcpp::Time(0), rclcpp::Duration(0, 0));
+      hardware_.write(rclcpp::Time(0), rclcpp::Duration(0, 0));
+      if (done())
+      {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  static double rpm(double rad_per_sec, double gear_ratio)
+  {
+    return rad_per_sec * 60 * gear_ratio / (2 * M_PI);
+  }
+
+  FakePumaBus bus_;
+  TestPumaHardware hardware_;
+};
+
+TEST_F(PumaDirectCanTest, WriteCommandsEachDeviceNumber)
+{
+  hardware_.commands()[0] = 1.0;
+  hardware_.commands()[1] = 0.5;
+
+  // Commands are only sent once the controllers are configured
+  ASSERT_TRUE(cycle([this]() {return bus_.commandedRpm(5) != 0.0 && bus_.commandedRpm(3) != 0.0;}));
+
+  EXPECT_NEAR(bus_.commandedRpm(5), rpm(1.0, GEAR_RATIO), 1e-3);
+  EXPECT_NEAR(bus_.commandedRpm(3), rpm(0.5, -GEAR_RATIO), 1e-3);
+}
+
+TEST_F(PumaDirectCanTest, ReadFeedbackFromEachDeviceNumber)
+{
+  bus_.setFeedback(5, rpm(0.5, GEAR_RATIO), 1.0);
+  bus_.setFeedback(3, rpm(0.25, GEAR_RATIO), 0.5);
+
+  ASSERT_TRUE(
+    cycle([this]() {return hardware_.velocities()[0] != 0.0 && hardware_.velocities()[1] != 0.0;}));
+
+  // Travel in revolutions of the motor, which turns GEAR_RATIO times per wheel revolution
+  EXPECT_NEAR(hardware_.velocities()[0], 0.5, 1e-3);
+  EXPECT_NEAR(hardware_.positions()[0], 2 * M_PI / GEAR_RATIO, 1e-3);
+  EXPECT_NEAR(hardware_.velocities()[1], -0.25, 1e-3);
+  EXPECT_NEAR(hardware_.positions()[1], -M_PI / GEAR_RATIO, 1e-3);
+}
@@ -0,0 +1,96 @@
+/**
+Software License Agreement (BSD)
+\file      test_puma_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/puma/hardware.hpp"
+
+using clearpath_hardware_interfaces::PumaHardware;
+
+class PumaHardwareTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  static hardware_interface::HardwareInfo hardwareInfo(const std::vector<std::string> & joints)
+  {
+    hardware_interface::HardwareInfo info;
+    info.name = "puma_hardware";
+    for (const auto & name : joints)
+    {
+      hardware_interface::ComponentInfo joint;
+      joint.name = name;
+      hardware_interface::InterfaceInfo interface;
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.command_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_POSITION;
+      joint.state_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.state_interfaces.push_back(interface);
+      info.joints.push_back(joint);
+    }
+    return info;
+  }
+};
+
+TEST_F(PumaHardwareTest, TopicModeInitializes)
+{
+  PumaHardware hardware;
+  EXPECT_EQ(
+    hardware.on_init(hardwareInfo({"left_wheel_joint", "right_wheel_joint"})),
+    hardware_interface::CallbackReturn::SUCCESS);
+  EXPECT_EQ(hardware.export_command_interfaces().size(), 2u);
+  EXPECT_EQ(hardware.export_state_interfaces().size(), 4u);
+}
+
+TEST_F(PumaHardwareTest, RejectsInvalidJointCount)
+{
+  PumaHardware hardware;
+  EXPECT_EQ(
+    hardware.on_init(hardwareInfo({"left_wheel_joint", "right_wheel_joint", "rear_wheel_joint"})),
+    hardware_interface::CallbackReturn::ERROR);
+}
+
+// Direct CAN mode must know each joint's device number before it opens the bus
+TEST_F(PumaHardwareTest, DirectCanRequiresCanIds)
+{
+  auto info = hardwareInfo({"left_wheel_joint", "right_wheel_joint"});
+  info.hardware_parameters["direct_can"] = "true";
+  info.hardware_parameters["canbus_dev"] = "vcan_missing";
+  info.joints[0].parameters["can_id"] = "2";
+
+  PumaHardware hardware;
+  EXPECT_EQ(hardware.on_init(info), hardware_interface::CallbackReturn::ERROR);
+}
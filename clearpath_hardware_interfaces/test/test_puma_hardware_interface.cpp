@@ -0,0 +1,144 @@
+/**
+Software License Agreement (BSD)
+\file      test_puma_hardware_interface.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/puma/hardware_interface.hpp"
+
+using clearpath_hardware_interfaces::PumaHardwareInterface;
+using clearpath_hardware_interfaces::PumaJointFeedback;
+using clearpath_motor_msgs::msg::PumaFeedback;
+using clearpath_motor_msgs::msg::PumaMultiFeedback;
+
+static constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+class PumaHardwareInterfaceTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    node_ = std::make_shared<PumaHardwareInterface>(
+      "puma_hardware_interface_test",
+      std::vector<std::string>({"left_wheel_joint", "right_wheel_joint"}));
+  }
+
+  static PumaFeedback feedback(
+    uint8_t device_number, const std::string & device_name, double speed, double travel)
+  {
+    PumaFeedback puma;
+    puma.device_number = device_number;
+    puma.device_name = device_name;
+    puma.speed = speed;
+    puma.travel = travel;
+    return puma;
+  }
+
+  // Deliver one PumaMultiFeedback message and read back the joint feedback
+  PumaJointFeedback receive(const std::vector<PumaFeedback> & drivers)
+  {
+    auto msg = std::make_shared<PumaMultiFeedback>();
+    msg->drivers_feedback = drivers;
+    node_->feedback_callback(msg);
+
+    PumaJointFeedback joints;
+    EXPECT_TRUE(node_->get_feedback(joints));
+    return joints;
+  }
+
+  std::shared_ptr<PumaHardwareInterface> node_;
+};
+
+TEST_F(PumaHardwareInterfaceTest, NoFeedbackBeforeFirstMessage)
+{
+  PumaJointFeedback joints;
+  EXPECT_FALSE(node_->get_feedback(joints));
+}
+
+TEST_F(PumaHardwareInterfaceTest, DispatchesFirstAndLastDeviceNumbers)
+{
+  PumaJointFeedback joints = receive(
+    {feedback(63, "right_wheel_joint", 2.0, 20.0), feedback(0, "left_wheel_joint", 1.0, 10.0)});
+  EXPECT_EQ(joints.speed[0], 1.0);
+  EXPECT_EQ(joints.travel[0], 10.0);
+  EXPECT_EQ(joints.speed[1], 2.0);
+  EXPECT_EQ(joints.travel[1], 20.0);
+  EXPECT_EQ(joints.sequence, 1u);
+
+  // Resolved by name once, then by device number
+  joints = receive({feedback(63, "left_wheel_joint", 3.0, 30.0)});
+  EXPECT_EQ(joints.speed[0], 1.0);
+  EXPECT_EQ(joints.speed[1], 3.0);
+  EXPECT_EQ(joints.travel[1], 30.0);
+}
+
+TEST_F(PumaHardwareInterfaceTest, KeepsLastGoodValuesOnNaN)
+{
+  receive({feedback(1, "left_wheel_joint", 1.0, 10.0), feedback(2, "right_wheel_joint", 2.0, 20.0)});
+
+  PumaJointFeedback joints = receive(
+    {feedback(1, "left_wheel_joint", NaN, 11.0), feedback(2, "right_wheel_joint", 2.5, NaN)});
+  EXPECT_EQ(joints.speed[0], 1.0);
+  EXPECT_EQ(joints.travel[0], 10.0);
+  EXPECT_EQ(joints.speed[1], 2.0);
+  EXPECT_EQ(joints.travel[1], 20.0);
+  EXPECT_EQ(joints.sequence, 2u);
+}
+
+TEST_F(PumaHardwareInterfaceTest, RejectsOutOfRangeDeviceNumbers)
+{
+  PumaJointFeedback joints = receive(
+    {feedback(64, "left_wheel_joint", 1.0, 10.0), feedback(255, "right_wheel_joint", 2.0, 20.0)});
+  EXPECT_EQ(joints.speed[0], 0.0);
+  EXPECT_EQ(joints.speed[1], 0.0);
+  EXPECT_EQ(joints.sequence, 1u);
+
+  // Valid device numbers still resolve afterwards
+  joints = receive({feedback(0, "left_wheel_joint", 1.0, 10.0)});
+  EXPECT_EQ(joints.speed[0], 1.0);
+}
+
+TEST_F(PumaHardwareInterfaceTest, RejectsUnknownDevices)
+{
+  PumaJointFeedback joints = receive({feedback(7, "front_wheel_joint", 1.0, 10.0)});
+  EXPECT_EQ(joints.speed[0], 0.0);
+  EXPECT_EQ(joints.speed[1], 0.0);
+
+  // The device number stays rejected without another name lookup
+  joints = receive({feedback(7, "left_wheel_joint", 1.0, 10.0)});
+  EXPECT_EQ(joints.speed[0], 0.0);
+}
@@ -0,0 +1,223 @@
+/**
+Software License Agreement (BSD)
+\file      test_w200_hardware.cpp
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "clearpath_hardware_interfaces/w200/hardware.hpp"
+
+using clearpath_hardware_interfaces::W200Feedback;
+using clearpath_hardware_interfaces::W200Hardware;
+using clearpath_hardware_interfaces::W200HardwareInterface;
+
+// Exposes the feedback integration of W200Hardware
+class TestW200Hardware : public W200Hardware
+{
+public:
+  using W200Hardware::integrateFeedback;
+
+  const std::vector<double> & travel() const
+  {
+    return hw_states_position_measured_;
+  }
+};
+
+class W200IntegrationTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    hardware_interface::HardwareInfo info;
+    info.name = "w200_hardware";
+    info.hardware_parameters["feedback_timeout"] = std::to_string(FEEDBACK_TIMEOUT);
+    for (const char * name : {"front_left_wheel_joint", "front_right_wheel_joint"})
+    {
+      hardware_interface::ComponentInfo joint;
+      joint.name = name;
+      hardware_interface::InterfaceInfo interface;
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.command_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_POSITION;
+      joint.state_interfaces.push_back(interface);
+      interface.name = hardware_interface::HW_IF_VELOCITY;
+      joint.state_interfaces.push_back(interface);
+      info.joints.push_back(joint);
+    }
+    ASSERT_EQ(hardware_.on_init(info), hardware_interface::CallbackReturn::SUCCESS);
+    ASSERT_EQ(hardware_.export_command_interfaces().size(), 2u);
+  }
+
+  // Integrate count pairs of constant velocity, period seconds apart with up to 20 % jitter,
+  // starting at start ns. Returns the stamp of the last pair.
+  int64_t feed(const int64_t start, const double period, const int count, const bool forced = false)
+  {
+    static constexpr double JITTER[] = {0.0, 0.2, -0.1, -0.2, 0.1};
+    int64_t stamp = start;
+    for (int i = 0; i < count; i++)
+    {
+      if (i > 0)
+      {
+        stamp += static_cast<int64_t>(period * (1.0 + JITTER[i % 5]) * 1e9);
+      }
+      W200Feedback feedback{};
+      feedback.velocity[0] = LEFT_VELOCITY;
+      feedback.velocity[1] = RIGHT_VELOCITY;
+      feedback.stamp = stamp;
+      feedback.sequence = i + 1;
+      feedback.forced = forced;
+      hardware_.integrateFeedback(feedback);
+    }
+    return stamp;
+  }
+
+  void expectTravel(const double seconds)
+  {
+    EXPECT_NEAR(hardware_.travel()[0], LEFT_VELOCITY * seconds, MAX_ERROR);
+    EXPECT_NEAR(hardware_.travel()[1], RIGHT_VELOCITY * seconds, MAX_ERROR);
+  }
+
+  static constexpr double FEEDBACK_TIMEOUT = 0.1;
+  static constexpr double LEFT_VELOCITY = 2.5;
+  static constexpr double RIGHT_VELOCITY = -1.25;
+  static constexpr double MAX_ERROR = 1e-9;
+  static constexpr int64_t START = 1000000000;
+
+  TestW200Hardware hardware_;
+};
+
+// At constant speed, travel is velocity times the time between the first and last sample,
+// however the samples are spaced and at any feedback rate
+TEST_F(W200IntegrationTest, ConstantSpeedAt20Hz)
+{
+  int64_t end = feed(START, 1.0 / 20, 40);
+  expectTravel((end - START) * 1e-9);
+}
+
+TEST_F(W200IntegrationTest, ConstantSpeedAt50Hz)
+{
+  int64_t end = feed(START, 1.0 / 50, 100);
+  expectTravel((end - START) * 1e-9);
+}
+
+TEST_F(W200IntegrationTest, ConstantSpeedAt100Hz)
+{
+  int64_t end = feed(START, 1.0 / 100, 200);
+  expectTravel((end - START) * 1e-9);
+}
+
+// Nothing is integrated across a gap longer than feedback_timeout
+TEST_F(W200IntegrationTest, SkipsGapLongerThanTimeout)
+{
+  int64_t first_end = feed(START, 1.0 / 50, 50);
+  int64_t second_start = first_end + static_cast<int64_t>(5 * FEEDBACK_TIMEOUT * 1e9);
+  int64_t second_end = feed(second_start, 1.0 / 50, 50);
+  expectTravel((first_end - START + second_end - second_start) * 1e-9);
+}
+
+// A gap shorter than feedback_timeout is still integrated
+TEST_F(W200IntegrationTest, IntegratesGapShorterThanTimeout)
+{
+  int64_t first_end = feed(START, 1.0 / 50, 50);
+  int64_t second_start = first_end + static_cast<int64_t>(0.9 * FEEDBACK_TIMEOUT * 1e9);
+  int64_t second_end = feed(second_start, 1.0 / 50, 50);
+  expectTravel((second_end - START) * 1e-9);
+}
+
+// No travel is integrated up to a forced pair, only from it onwards
+TEST_F(W200IntegrationTest, SkipsTravelUpToForcedPair)
+{
+  int64_t first_end = feed(START, 1.0 / 50, 50);
+  int64_t forced = feed(first_end + 20000000, 1.0 / 50, 1, true);
+  int64_t second_end = feed(forced + 20000000, 1.0 / 50, 50);
+  expectTravel((first_end - START + second_end - forced) * 1e-9);
+}
+
+class W200PairingTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  static std_msgs::msg::Float64::SharedPtr velocity(const double data)
+  {
+    auto msg = std::make_shared<std_msgs::msg::Float64>();
+    msg->data = data;
+    return msg;
+  }
+};
+
+TEST_F(W200PairingTest, PairsWithinSkewAreNotForced)
+{
+  W200HardwareInterface node("w200_pairing_test", 0.01, 0.1);
+  node.feedback_left_callback(velocity(1.0));
+  node.feedback_right_callback(velocity(-1.0));
+
+  W200Feedback feedback;
+  ASSERT_TRUE(node.get_feedback(feedback));
+  EXPECT_FALSE(feedback.forced);
+  EXPECT_EQ(feedback.velocity[0], 1.0);
+  EXPECT_EQ(feedback.velocity[1], -1.0);
+}
+
+// After several left samples without a right one inside the window, the late right sample is
+// paired with the latest left one and the pair is marked as forced
+TEST_F(W200PairingTest, PairsAfterDriftAreForced)
+{
+  W200HardwareInterface node("w200_pairing_test", 0.01, 10.0);
+  for (int i = 0; i < 5; i++)
+  {
+    node.feedback_left_callback(velocity(i));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  node.feedback_right_callback(velocity(-1.0));
+
+  W200Feedback feedback;
+  ASSERT_TRUE(node.get_feedback(feedback));
+  EXPECT_TRUE(feedback.forced);
+  EXPECT_EQ(feedback.velocity[0], 4.0);
+  EXPECT_EQ(feedback.velocity[1], -1.0);
+  EXPECT_FALSE(node.get_feedback(feedback));
+}
@@ -0,0 +1,85 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2024, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef PUMA_MOTOR_DRIVER_CAN_RX_BATCH_H
+#define PUMA_MOTOR_DRIVER_CAN_RX_BATCH_H
+
+#include <linux/can.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "can_msgs/msg/frame.hpp"
+
+namespace puma_motor_driver
+{
+
+/**
+ * Reads frames from a raw CAN socket with recvmmsg(), in place of receiving every frame
+ * on the bus through the SocketCAN interface. The kernel filters the socket down to the
+ * given Puma device numbers and stamps each frame as it is received.
+ *
+ * Not thread safe; receive() and frame() must be called from the same thread.
+ */
+class CanRxBatch
+{
+public:
+  static constexpr size_t MAX_FRAMES = 64;
+
+  CanRxBatch(const std::string & canbus_dev, const std::vector<uint8_t> & device_numbers);
+  ~CanRxBatch();
+
+  CanRxBatch(const CanRxBatch &) = delete;
+  CanRxBatch & operator=(const CanRxBatch &) = delete;
+
+  bool isOpen() const {return socket_ >= 0;}
+
+  /**
+   * Reads the frames waiting on the socket, up to MAX_FRAMES, without blocking.
+   * Returns the number of frames read; call again until it returns 0 to drain the socket.
+   */
+  size_t receive();
+
+  /**
+   * Copies a frame read by the last receive() into msg. Returns the time the kernel
+   * received it, in ns on the steady clock.
+   */
+  int64_t frame(const size_t index, can_msgs::msg::Frame & msg) const;
+
+private:
+  int socket_;
+  struct can_frame frames_[MAX_FRAMES];
+  struct iovec iovecs_[MAX_FRAMES];
+  struct mmsghdr msgs_[MAX_FRAMES];
+  char controls_[MAX_FRAMES][CMSG_SPACE(sizeof(struct timespec))];
+  int64_t stamps_[MAX_FRAMES];
+};
+
+}  // namespace puma_motor_driver
+
+#endif  // PUMA_MOTOR_DRIVER_CAN_RX_BATCH_H
@@ -0,0 +1,92 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2024, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef PUMA_MOTOR_DRIVER_CAN_TX_BATCH_H
+#define PUMA_MOTOR_DRIVER_CAN_TX_BATCH_H
+
+#include <linux/can.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "can_msgs/msg/frame.hpp"
+
+namespace puma_motor_driver
+{
+
+/**
+ * Collects the frames queued during one control cycle and writes them to a raw CAN
+ * socket with a single sendmmsg() call, instead of draining them one at a time on
+ * the SocketCAN interface's send timer. Frames it sends are not looped back to other
+ * sockets on this host, so they are never mistaken for controller responses.
+ *
+ * Not thread safe; queue() and flush() must be called from the same thread.
+ */
+class CanTxBatch
+{
+public:
+  static constexpr size_t MAX_FRAMES = 64;
+
+  explicit CanTxBatch(const std::string & canbus_dev);
+  ~CanTxBatch();
+
+  CanTxBatch(const CanTxBatch &) = delete;
+  CanTxBatch & operator=(const CanTxBatch &) = delete;
+
+  bool isOpen() const {return socket_ >= 0;}
+
+  /**
+   * Adds a frame to the batch. A full batch is flushed first.
+   */
+  void queue(const can_msgs::msg::Frame & msg);
+
+  /**
+   * Sends every queued frame. Returns the number of frames written. Frames the interface
+   * has no room for stay queued for the next flush, as they would on the SocketCAN
+   * interface; frames that fail for any other reason are dropped.
+   */
+  size_t flush();
+
+  /**
+   * Frames dropped since the last clearDroppedFrames(), either by a failed send or
+   * because the batch was still full of frames the interface had no room for.
+   */
+  uint64_t droppedFrames() const {return dropped_;}
+
+  void clearDroppedFrames() {dropped_ = 0;}
+
+private:
+  int socket_;
+  size_t count_;
+  uint64_t dropped_;
+  struct can_frame frames_[MAX_FRAMES];
+  struct iovec iovecs_[MAX_FRAMES];
+  struct mmsghdr msgs_[MAX_FRAMES];
+};
+
+}  // namespace puma_motor_driver
+
+#endif  // PUMA_MOTOR_DRIVER_CAN_TX_BATCH_H
@@ -0,0 +1,90 @@
+/**
+Software License Agreement (BSD)
+
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef PUMA_MOTOR_DRIVER_DEVICE_TABLE_H
+#define PUMA_MOTOR_DRIVER_DEVICE_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "can_msgs/msg/frame.hpp"
+#include "puma_motor_driver/can_proto.hpp"
+#include "puma_motor_driver/driver.hpp"
+
+namespace puma_motor_driver
+{
+
+/**
+ * Driver for each of the 64 CAN device numbers, so that a received frame is handed only to
+ * the driver it is addressed to rather than offered to every driver in turn.
+ */
+class DeviceTable
+{
+public:
+  DeviceTable()
+  {
+    drivers_.fill(nullptr);
+  }
+
+  /**
+   * Points the table at drivers. The vector must not be resized while the table is in use.
+   */
+  void assign(std::vector<Driver> & drivers)
+  {
+    drivers_.fill(nullptr);
+    for (auto & driver : drivers) {
+      drivers_[driver.deviceNumber() & CAN_MSGID_DEVNO_M] = &driver;
+    }
+  }
+
+  /**
+   * @return the driver msg is addressed to, nullptr if there is none.
+   */
+  Driver * find(const can_msgs::msg::Frame & msg) const
+  {
+    return drivers_[msg.id & CAN_MSGID_DEVNO_M];
+  }
+
+  /**
+   * Processes a received frame in the driver it is addressed to.
+   *
+   * @param[in] stamp Steady clock time in ns the frame was received, 0 for now.
+   * @return false if no driver has the frame's device number.
+   */
+  bool dispatch(const can_msgs::msg::Frame::SharedPtr & msg, const int64_t stamp = 0) const
+  {
+    Driver * driver = find(*msg);
+    if (!driver) {
+      return false;
+    }
+    driver->processMessage(msg, stamp);
+    return true;
+  }
+
+private:
+  std::array<Driver *, CAN_MSGID_DEVNO_M + 1> drivers_;
+};
+
+}  // namespace puma_motor_driver
+
+#endif  // PUMA_MOTOR_DRIVER_DEVICE_TABLE_H
@@ -33,6 +33,7 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 #include "clearpath_motor_msgs/msg/puma_status.hpp"
 
 #include "puma_motor_driver/can_proto.hpp"
+#include "puma_motor_driver/can_tx_batch.hpp"
 
 namespace puma_motor_driver
 {
@@ -44,9 +45,16 @@ public:
     const std::shared_ptr<clearpath_ros2_socketcan_interface::SocketCANInterface> interface,
     std::shared_ptr<rclcpp::Node> nh,
     const uint8_t & device_number,
-    const std::string & device_name);
+    const std::string & device_name,
+    std::shared_ptr<CanTxBatch> tx_batch = nullptr);
 
-  void processMessage(const can_msgs::msg::Frame::SharedPtr received_msg);
+  /**
+   * Updates the cache with a frame received from the bus.
+   *
+   * @param[in] received_msg Received frame, ignored unless addressed from this device.
+   * @param[in] stamp Steady clock time in ns the frame was received, 0 for now.
+   */
+  void processMessage(const can_msgs::msg::Frame::SharedPtr received_msg, int64_t stamp = 0);
 
   double radPerSecToRpm() const;
 
@@ -109,6 +117,20 @@ public:
    * @param[in] cmd Value to command in rad/s.
    */
   void commandSpeed(const double cmd);
+  /**
+   * Stage set-points in a synchronous group instead of applying them on arrival.
+   * Staged set-points take effect together when sendSync() names their group.
+   *
+   * @param[in] group Group bit mask, 0 to apply set-points immediately.
+   */
+  void setSyncGroup(const uint8_t group);
+  /**
+   * Broadcast a synchronous update, applying the set-points staged by every
+   * motor controller on the bus in the given groups.
+   *
+   * @param[in] groups Group bit mask.
+   */
+  void sendSync(const uint8_t groups);
   // void currentSet(float cmd);
   // void positionSet(float cmd);
   // void neutralSet();
@@ -149,6 +171,21 @@ public:
    * @param[in] d Value to set.
    */
   void setGains(const double p, const double i, const double d);
+  /**
+   * Have the motor controller stream its status in periodic status messages, which
+   * are configured along with the other parameters. Feedback and status fields then
+   * fill without being requested, apart from the power flag, control mode and
+   * set-point, which periodic status cannot carry.
+   *
+   * @param[in] period_ms Streaming period in milliseconds, 0 to poll instead.
+   */
+  void setPeriodicStatus(const uint16_t period_ms);
+  /**
+   * Check whether status is streamed rather than polled.
+   *
+   * @return true if periodic status is enabled.
+   */
+  bool periodicStatus() const {return periodic_status_ms_ != 0;}
 
   /**
    * Check fault response field was received.
@@ -326,14 +363,23 @@ public:
 
   /**
    * The requesting part of the state machine that sends a message to the
-   * motor controller requesting a parameter be set.
+   * motor controller requesting a parameter be set. In pipelined mode, sends
+   * every parameter not yet verified, each followed by its readback request.
    */
   void configureParams();
   /**
    * The verifying part of the state machine that checks the response of
-   * the motor controller to ensure the value was set.
+   * the motor controller to ensure the value was set. In pipelined mode,
+   * advances past every parameter whose readback since configuration began matches.
    */
   void verifyParams();
+  /**
+   * Configure all parameters in one burst per cycle instead of one parameter
+   * at a time, so that configuration takes a few cycles instead of dozens.
+   *
+   * @param[in] pipelined Whether to pipeline configuration.
+   */
+  void setPipelinedConfiguration(const bool pipelined);
   /**
    * Gets if the driver has been configured.
    *
@@ -443,11 +489,66 @@ public:
 
   uint8_t deviceNumber() const {return device_number_;}
 
+  /**
+   * Round trip times of the requests sent by the request*() methods in one API class,
+   * accumulated since the last clearBusStats(). A request is counted as missing when
+   * it is sent again before its response arrived.
+   */
+  struct RoundTrip
+  {
+    uint32_t responses;
+    uint32_t missing;
+    double total;  // s
+    double max;  // s
+  };
+
+  // API classes with cached response fields, CAN_API_MC_VOLTAGE to CAN_API_MC_CFG
+  static constexpr uint8_t API_CLASS_COUNT = 8;
+
+  const RoundTrip & roundTrip(const uint8_t api_class) const {return round_trip_[api_class];}
+
+  /**
+   * Age of the motion feedback, the older of the position and speed fields.
+   *
+   * @return seconds since both were last received, infinity if either never was.
+   */
+  double feedbackAge();
+  /**
+   * Count of motion feedback updates, the lower of the position and speed receive counts.
+   *
+   * @return 0 until both have been received.
+   */
+  uint32_t feedbackSequence();
+
+  uint64_t txFrames() const {return tx_frames_;}
+
+  uint64_t txBits() const {return tx_bits_;}
+
+  /**
+   * Reset the round trip and transmit statistics.
+   */
+  void clearBusStats();
+
+  /**
+   * Estimate the bits a frame occupies on the bus, including worst case bit stuffing
+   * and the interframe space.
+   *
+   * @return number of bits.
+   */
+  static uint32_t frameBits(const can_msgs::msg::Frame & msg);
+
   // Only used internally but is used for testing.
   struct Field
   {
     uint8_t data[4];
     bool received;
+    // Steady clock time in ns of a request still waiting for its response, 0 if none
+    int64_t requested;
+    // Number of times and steady clock time in ns the field was last received
+    uint32_t sequence;
+    int64_t stamp;
+    // Value of sequence when configuration last began, to tell readbacks received since
+    uint32_t configuring_sequence;
 
     float interpretFixed8x8()
     {
@@ -462,6 +563,8 @@ public:
 
 private:
   std::shared_ptr<clearpath_ros2_socketcan_interface::SocketCANInterface> interface_;
+  // Frames go out through the batch when set, otherwise through the interface's queue
+  std::shared_ptr<CanTxBatch> tx_batch_;
   std::shared_ptr<rclcpp::Node> nh_;
   uint8_t device_number_;
   std::string device_name_;
@@ -475,19 +578,57 @@ private:
   double gain_d_;
   uint16_t encoder_cpr_;
   float gear_ratio_;
+  uint8_t sync_group_;
+  uint16_t periodic_status_ms_;
+  // Bit per periodic status message received since configuration began
+  uint8_t periodic_status_received_;
+
+  bool pipelined_configuration_;
+  // Steady clock time in ns that configuration started
+  int64_t configuration_started_;
+
+  RoundTrip round_trip_[API_CLASS_COUNT];
+  uint64_t tx_frames_;
+  uint64_t tx_bits_;
 
   /**
    * Helpers to generate data for CAN messages.
    */
   can_msgs::msg::Frame::SharedPtr can_msg_;
   void sendId(const uint32_t id);
+  void sendRequest(const uint32_t id);
   void sendUint8(const uint32_t id, const uint8_t value);
   void sendUint16(const uint32_t id, const uint16_t value);
-  void sendFixed8x8(const uint32_t id, const float value);
-  void sendFixed16x16(const uint32_t id, const double value);
+  void sendFixed8x8(const uint32_t id, const float value, const uint8_t group = 0);
+  void sendFixed16x16(const uint32_t id, const double value, const uint8_t group = 0);
+  void sendBytes(const uint32_t id, const uint8_t * data, const uint8_t length);
+  void send(const can_msgs::msg::Frame & msg);
   can_msgs::msg::Frame getMsg(const uint32_t id);
-  uint32_t getApi(const can_msgs::msg::Frame msg);
-  uint32_t getDeviceNumber(const can_msgs::msg::Frame msg);
+  uint32_t getApi(const can_msgs::msg::Frame & msg);
+  uint32_t getDeviceNumber(const can_msgs::msg::Frame & msg);
+
+  /**
+   * Unpack a periodic status data message into the status fields it carries.
+   */
+  void processPeriodicStatus(
+    const uint8_t message, const can_msgs::msg::Frame & msg, const int64_t stamp);
+
+  /**
+   * Send the set message of one configuration state.
+   */
+  void configureState(const uint8_t state);
+  /**
+   * The configuration state after a verified one.
+   */
+  uint8_t nextState(const uint8_t state) const;
+  /**
+   * The API that reads back a configuration state's parameter, 0 if it has none.
+   */
+  uint32_t readbackApi(const uint8_t state) const;
+  /**
+   * Check a configuration state against a readback received since configuration began.
+   */
+  bool stateVerified(const uint8_t state);
 
   /**
    * Comparing the raw bytes of the 16x16 fixed-point numbers
@@ -505,21 +646,22 @@ private:
    */
   bool verifyRaw8x8(const uint8_t * received, const float expected);
 
-  Field voltage_fields_[4];
-  Field spd_fields_[7];
-  Field vcomp_fields_[5];
-  Field pos_fields_[7];
-  Field ictrl_fields_[6];
-  Field status_fields_[15];
-  Field cfg_fields_[15];
-
-  Field * voltageFieldForMessage(uint32_t api);
-  Field * spdFieldForMessage(uint32_t api);
-  Field * vcompFieldForMessage(uint32_t api);
-  Field * posFieldForMessage(uint32_t api);
-  Field * ictrlFieldForMessage(uint32_t api);
-  Field * statusFieldForMessage(uint32_t api);
-  Field * cfgFieldForMessage(uint32_t api);
+  /**
+   * Cached response data for every API with a field, in one flat array. Slots are
+   * assigned by a table from the 10 bit API number, see driver.cpp.
+   */
+  static constexpr uint8_t FIELD_COUNT = 61;
+  Field fields_[FIELD_COUNT];
+
+  /**
+   * Field for a received message's API, nullptr if responses to it are not cached.
+   */
+  Field * fieldForApi(uint32_t api);
+  /**
+   * Field for a message id known at compile time.
+   */
+  template<uint32_t Id>
+  Field * fieldFor();
 };
 
 }  // namespace puma_motor_driver
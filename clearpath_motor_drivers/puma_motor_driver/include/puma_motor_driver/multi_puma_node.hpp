@@ -24,8 +24,16 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 #ifndef PUMA_MOTOR_DRIVER_MULTI_PUMA_NODE_H
 #define PUMA_MOTOR_DRIVER_MULTI_PUMA_NODE_H
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "std_msgs/msg/float64.hpp"
+#include "std_msgs/msg/float64_multi_array.hpp"
 #include "sensor_msgs/msg/joint_state.hpp"
 
 #include "clearpath_motor_msgs/msg/puma_multi_status.hpp"
@@ -35,22 +43,12 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 
 #include "clearpath_ros2_socketcan_interface/socketcan_interface.hpp"
 
+#include "puma_motor_driver/can_rx_batch.hpp"
+#include "puma_motor_driver/can_tx_batch.hpp"
+#include "puma_motor_driver/device_table.hpp"
 #include "puma_motor_driver/driver.hpp"
 // #include "puma_motor_driver/diagnostic_updater.hpp"
 
-namespace FeedbackBit
-{
-enum
-{
-  DutyCycle,
-  Current,
-  Position,
-  Speed,
-  Setpoint,
-  Count,
-};
-}
-
 namespace StatusBit
 {
 enum
@@ -70,6 +68,7 @@ class MultiPumaNode
 {
 public:
   MultiPumaNode(const std::string node_name);
+  ~MultiPumaNode();
 
   /**
    * Receives desired motor speeds in sensor_msgs::JointState format and
@@ -78,9 +77,10 @@ public:
   void cmdCallback(const sensor_msgs::msg::JointState::SharedPtr msg);
 
   /**
-   * Checks if feedback fields have been received from each motor driver.
-   * If feedback is avaiable, creates the feedback message and returns
-   * true. Otherwise, returns false.
+   * Creates the feedback message from each motor driver's latest feedback. Drivers whose
+   * position and speed have never been received, or are older than feedback_timeout,
+   * report NaN so that one silent driver does not hold back or corrupt the others.
+   * Returns false if no driver has fresh feedback.
   */
   bool getFeedback();
 
@@ -101,6 +101,12 @@ public:
   */
   void publishStatus();
 
+  /**
+   * Publishes CAN bus load and per device round trip times accumulated since the last
+   * call, as diagnostics and as a compact metrics array, then starts a new window.
+  */
+  void publishBusStats();
+
   /**
    * Checks that all motor drivers have been configured and are active.
   */
@@ -120,15 +126,38 @@ public:
   */
   void run();
 
+  /**
+   * Runs the control loop on a dedicated thread instead of the executor's wall timer.
+   * Cycles start at absolute timerfd deadlines, optionally under SCHED_FIFO and pinned
+   * to a CPU, and missed deadlines are counted as overruns.
+  */
+  void controlThread();
+
 private:
   std::shared_ptr<clearpath_ros2_socketcan_interface::SocketCANInterface> interface_;
+  // Sends each cycle's frames together when batch_tx is set, otherwise nullptr
+  std::shared_ptr<puma_motor_driver::CanTxBatch> tx_batch_;
+  // Receives our drivers' frames directly when raw_rx and batch_tx are set, otherwise nullptr
+  std::unique_ptr<puma_motor_driver::CanRxBatch> rx_batch_;
   std::vector<puma_motor_driver::Driver> drivers_;
+  puma_motor_driver::DeviceTable device_drivers_;
+  // Driver for each joint name, looked up by cmdCallback()
+  std::unordered_map<std::string, puma_motor_driver::Driver *> name_drivers_;
 
   bool active_;
+  bool batch_tx_;
+  bool raw_rx_;
   double gear_ratio_;
   int encoder_cpr_;
   int freq_;
-  uint8_t status_count_;
+  int periodic_status_;
+  bool pipelined_configuration_;
+  // Synchronous update group bit mask, 0 to apply set-points on arrival
+  int sync_group_;
+  // Seconds before feedback is stale, FEEDBACK_TIMEOUT_PERIODS control periods unless set
+  static constexpr double FEEDBACK_TIMEOUT_PERIODS = 3.0;
+  double feedback_timeout_;
+  uint32_t status_count_;
   uint8_t desired_mode_;
   std::string canbus_dev_;
   std::vector<std::string> joint_names_;
@@ -149,6 +178,27 @@ private:
   rclcpp::Subscription<sensor_msgs::msg::JointState>::SharedPtr cmd_sub_;
   rclcpp::TimerBase::SharedPtr run_timer_;
 
+  // Dedicated control thread, used in place of run_timer_ when control_thread.enabled is set
+  bool control_thread_enabled_;
+  int control_thread_priority_;
+  int control_thread_cpu_;
+  std::thread control_thread_;
+  std::atomic_bool control_thread_running_;
+  uint64_t overruns_;
+  // Serializes run() and cmdCallback(), which can run on different threads
+  std::mutex driver_mutex_;
+
+  // Bus statistics, reset by publishBusStats()
+  int bitrate_;
+  uint64_t rx_frames_;
+  uint64_t rx_bits_;
+  rclcpp::Time bus_stats_start_;
+  // Each driver's feedbackSequence() at the start of the window
+  std::vector<uint32_t> feedback_sequences_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+  rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr metrics_pub_;
+  rclcpp::TimerBase::SharedPtr bus_stats_timer_;
+
 };
 
 #endif // PUMA_MOTOR_DRIVER_PUMA_NODE_H
@@ -0,0 +1,173 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2024, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "puma_motor_driver/can_rx_batch.hpp"
+
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "puma_motor_driver/can_proto.hpp"
+
+namespace puma_motor_driver
+{
+
+namespace
+{
+
+int64_t toNs(const struct timespec & time)
+{
+  return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+}  // namespace
+
+CanRxBatch::CanRxBatch(const std::string & canbus_dev, const std::vector<uint8_t> & device_numbers)
+: socket_(-1)
+{
+  memset(frames_, 0, sizeof(frames_));
+  memset(msgs_, 0, sizeof(msgs_));
+  memset(stamps_, 0, sizeof(stamps_));
+  for (size_t i = 0; i < MAX_FRAMES; i++) {
+    iovecs_[i].iov_base = &frames_[i];
+    iovecs_[i].iov_len = sizeof(struct can_frame);
+    msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if (fd < 0) {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("can_rx_batch"), "Failed to open CAN socket: %s", strerror(errno));
+    return;
+  }
+
+  // Only pass extended data frames from our motor controllers, leaving the rest of the
+  // bus traffic in the kernel.
+  std::vector<struct can_filter> filters;
+  for (auto device_number : device_numbers) {
+    struct can_filter filter;
+    filter.can_id = CAN_MSGID_MFR_LM | CAN_MSGID_DTYPE_MOTOR |
+      (device_number & CAN_MSGID_DEVNO_M) | CAN_EFF_FLAG;
+    filter.can_mask = CAN_MSGID_MFR_M | CAN_MSGID_DTYPE_M | CAN_MSGID_DEVNO_M |
+      CAN_EFF_FLAG | CAN_RTR_FLAG;
+    filters.push_back(filter);
+  }
+  int timestamps = 1;
+  if (setsockopt(
+      fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+      filters.size() * sizeof(struct can_filter)) < 0 ||
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &timestamps, sizeof(timestamps)) < 0)
+  {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("can_rx_batch"), "Failed to configure CAN socket: %s", strerror(errno));
+    close(fd);
+    return;
+  }
+
+  struct sockaddr_can addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.can_family = AF_CAN;
+  addr.can_ifindex = if_nametoindex(canbus_dev.c_str());
+  if (addr.can_ifindex == 0 ||
+    bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+  {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("can_rx_batch"), "Failed to bind CAN socket to %s: %s",
+      canbus_dev.c_str(), strerror(errno));
+    close(fd);
+    return;
+  }
+  socket_ = fd;
+}
+
+CanRxBatch::~CanRxBatch()
+{
+  if (socket_ >= 0) {
+    close(socket_);
+  }
+}
+
+size_t CanRxBatch::receive()
+{
+  if (socket_ < 0) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < MAX_FRAMES; i++) {
+    msgs_[i].msg_hdr.msg_control = controls_[i];
+    msgs_[i].msg_hdr.msg_controllen = sizeof(controls_[i]);
+  }
+
+  int result;
+  do {
+    result = recvmmsg(socket_, msgs_, MAX_FRAMES, MSG_DONTWAIT, NULL);
+  } while (result < 0 && errno == EINTR);
+  if (result < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      RCLCPP_WARN(
+        rclcpp::get_logger("can_rx_batch"), "Failed to receive CAN frames: %s", strerror(errno));
+    }
+    return 0;
+  }
+
+  // Kernel timestamps are on the realtime clock; move them onto the steady clock, and never
+  // later than now should the realtime clock step.
+  struct timespec realtime, steady;
+  clock_gettime(CLOCK_REALTIME, &realtime);
+  clock_gettime(CLOCK_MONOTONIC, &steady);
+  const int64_t offset = toNs(steady) - toNs(realtime);
+
+  for (int i = 0; i < result; i++) {
+    stamps_[i] = toNs(steady);
+    struct msghdr & hdr = msgs_[i].msg_hdr;
+    for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+        struct timespec stamp;
+        memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+        stamps_[i] = std::min(toNs(stamp) + offset, stamps_[i]);
+      }
+    }
+  }
+  return result;
+}
+
+int64_t CanRxBatch::frame(const size_t index, can_msgs::msg::Frame & msg) const
+{
+  const struct can_frame & frame = frames_[index];
+  msg.is_extended = frame.can_id & CAN_EFF_FLAG;
+  msg.is_rtr = frame.can_id & CAN_RTR_FLAG;
+  msg.is_error = frame.can_id & CAN_ERR_FLAG;
+  msg.id = frame.can_id & (msg.is_extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+  msg.dlc = std::min<uint8_t>(frame.can_dlc, CAN_MAX_DLEN);
+  std::copy(std::begin(frame.data), std::end(frame.data), std::begin(msg.data));
+  return stamps_[index];
+}
+
+}  // namespace puma_motor_driver
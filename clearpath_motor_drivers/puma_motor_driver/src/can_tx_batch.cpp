@@ -0,0 +1,155 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2024, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "puma_motor_driver/can_tx_batch.hpp"
+
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#include "rclcpp/rclcpp.hpp"
+
+namespace puma_motor_driver
+{
+
+CanTxBatch::CanTxBatch(const std::string & canbus_dev)
+: socket_(-1),
+  count_(0),
+  dropped_(0)
+{
+  memset(frames_, 0, sizeof(frames_));
+  memset(msgs_, 0, sizeof(msgs_));
+  for (size_t i = 0; i < MAX_FRAMES; i++) {
+    iovecs_[i].iov_base = &frames_[i];
+    iovecs_[i].iov_len = sizeof(struct can_frame);
+    msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if (fd < 0) {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("can_tx_batch"), "Failed to open CAN socket: %s", strerror(errno));
+    return;
+  }
+
+  // The socket only transmits, so it should not buffer any received frames.
+  setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, NULL, 0);
+
+  // Nor should other sockets on this host receive what it sends. A set echoed back has the
+  // same ID and payload as the controller's readback, and would be cached as a response.
+  int loopback = 0;
+  if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_LOOPBACK, &loopback, sizeof(loopback)) < 0) {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("can_tx_batch"), "Failed to disable CAN loopback: %s", strerror(errno));
+    close(fd);
+    return;
+  }
+
+  struct sockaddr_can addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.can_family = AF_CAN;
+  addr.can_ifindex = if_nametoindex(canbus_dev.c_str());
+  if (addr.can_ifindex == 0 ||
+    bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+  {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("can_tx_batch"), "Failed to bind CAN socket to %s: %s",
+      canbus_dev.c_str(), strerror(errno));
+    close(fd);
+    return;
+  }
+  socket_ = fd;
+}
+
+CanTxBatch::~CanTxBatch()
+{
+  if (socket_ >= 0) {
+    close(socket_);
+  }
+}
+
+void CanTxBatch::queue(const can_msgs::msg::Frame & msg)
+{
+  if (count_ == MAX_FRAMES) {
+    flush();
+  }
+  if (count_ == MAX_FRAMES) {
+    // Still full of frames the interface had no room for
+    dropped_++;
+    return;
+  }
+
+  struct can_frame & frame = frames_[count_++];
+  frame.can_id = msg.id;
+  if (msg.is_extended) {
+    frame.can_id |= CAN_EFF_FLAG;
+  }
+  if (msg.is_rtr) {
+    frame.can_id |= CAN_RTR_FLAG;
+  }
+  if (msg.is_error) {
+    frame.can_id |= CAN_ERR_FLAG;
+  }
+  frame.can_dlc = std::min<uint8_t>(msg.dlc, CAN_MAX_DLEN);
+  std::copy(std::begin(msg.data), std::end(msg.data), std::begin(frame.data));
+}
+
+size_t CanTxBatch::flush()
+{
+  size_t sent = 0;
+  bool retry = false;
+  while (socket_ >= 0 && sent < count_) {
+    int result = sendmmsg(socket_, &msgs_[sent], count_ - sent, 0);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // A full transmit queue is reported as ENOBUFS rather than by blocking.
+      retry = errno == ENOBUFS || errno == EAGAIN;
+      if (!retry) {
+        RCLCPP_WARN(
+          rclcpp::get_logger("can_tx_batch"), "Dropped %zu CAN frames: %s", count_ - sent,
+          strerror(errno));
+        dropped_ += count_ - sent;
+      }
+      break;
+    }
+    sent += result;
+  }
+
+  if (retry) {
+    // Keep the unsent frames, in order, for the next flush.
+    std::copy(frames_ + sent, frames_ + count_, frames_);
+    count_ -= sent;
+  } else {
+    count_ = 0;
+  }
+  return sent;
+}
+
+}  // namespace puma_motor_driver
@@ -26,14 +26,134 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 
 #include "puma_motor_driver/driver.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 #include <cstring>
+#include <limits>
 #include <math.h>
 #include "rclcpp/rclcpp.hpp"
 
 namespace puma_motor_driver
 {
 
+namespace
+{
+// Number of cached fields in each API class, indexed by the class number in the
+// CAN_MSGID_API_CLASS_M bits. Classes without cached fields have a count of 0.
+constexpr uint8_t API_CLASS_FIELDS[] = {
+  4,   // CAN_API_MC_VOLTAGE
+  7,   // CAN_API_MC_SPD
+  5,   // CAN_API_MC_VCOMP
+  7,   // CAN_API_MC_POS
+  6,   // CAN_API_MC_ICTRL
+  16,  // CAN_API_MC_STATUS
+  0,   // CAN_API_MC_PSTAT
+  16,  // CAN_API_MC_CFG
+};
+static_assert(
+  sizeof(API_CLASS_FIELDS) / sizeof(API_CLASS_FIELDS[0]) == Driver::API_CLASS_COUNT,
+  "Every API class with fields needs a field count");
+constexpr uint32_t API_ID_BITS = 4;
+constexpr uint32_t API_COUNT = (CAN_MSGID_API_M >> CAN_MSGID_API_S) + 1;
+constexpr int8_t NO_FIELD = -1;
+
+struct FieldSlots
+{
+  int8_t slot[API_COUNT];
+  uint8_t count;
+};
+
+// Field slot of every 10 bit API number, NO_FIELD if its responses are not cached
+constexpr FieldSlots makeFieldSlots()
+{
+  FieldSlots slots{};
+  for (uint32_t api = 0; api < API_COUNT; api++) {
+    slots.slot[api] = NO_FIELD;
+  }
+  for (uint32_t api_class = 0; api_class < Driver::API_CLASS_COUNT; api_class++) {
+    for (uint32_t id = 0; id < API_CLASS_FIELDS[api_class]; id++) {
+      slots.slot[(api_class << API_ID_BITS) | id] = slots.count++;
+    }
+  }
+  return slots;
+}
+
+constexpr FieldSlots FIELD_SLOTS = makeFieldSlots();
+
+constexpr int8_t fieldSlot(uint32_t id)
+{
+  return FIELD_SLOTS.slot[(id & CAN_MSGID_API_M) >> CAN_MSGID_API_S];
+}
+
+constexpr uint8_t apiClass(uint32_t id)
+{
+  return (id & CAN_MSGID_API_CLASS_M) >> (CAN_MSGID_API_S + API_ID_BITS);
+}
+
+int64_t steadyNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Contents of each periodic status message, as the LM_PSTAT_* code of every data byte.
+constexpr uint8_t PERIODIC_STATUS_COUNT = 3;
+constexpr uint8_t PERIODIC_STATUS_LENGTH = 8;
+constexpr uint8_t PERIODIC_STATUS_LAYOUT[PERIODIC_STATUS_COUNT][PERIODIC_STATUS_LENGTH] = {
+  {
+    LM_PSTAT_POS_B0, LM_PSTAT_POS_B1, LM_PSTAT_POS_B2, LM_PSTAT_POS_B3,
+    LM_PSTAT_SPD_B0, LM_PSTAT_SPD_B1, LM_PSTAT_SPD_B2, LM_PSTAT_SPD_B3,
+  },
+  {
+    LM_PSTAT_VOLTOUT_B0, LM_PSTAT_VOLTOUT_B1, LM_PSTAT_CURRENT_B0, LM_PSTAT_CURRENT_B1,
+    LM_PSTAT_VOLTBUS_B0, LM_PSTAT_VOLTBUS_B1, LM_PSTAT_TEMP_B0, LM_PSTAT_TEMP_B1,
+  },
+  {
+    LM_PSTAT_VOUT_B0, LM_PSTAT_VOUT_B1, LM_PSTAT_FAULT, LM_PSTAT_END,
+  },
+};
+
+// Status field and byte within it that a periodic status byte code fills, api 0 if none.
+struct StatusByte
+{
+  uint32_t api;
+  uint8_t offset;
+};
+
+constexpr StatusByte statusByte(uint8_t code)
+{
+  struct Range
+  {
+    uint8_t first, last;
+    uint32_t api;
+  };
+  constexpr Range ranges[] = {
+    {LM_PSTAT_VOLTOUT_B0, LM_PSTAT_VOLTOUT_B1, LM_API_STATUS_VOLTOUT},
+    {LM_PSTAT_VOLTBUS_B0, LM_PSTAT_VOLTBUS_B1, LM_API_STATUS_VOLTBUS},
+    {LM_PSTAT_CURRENT_B0, LM_PSTAT_CURRENT_B1, LM_API_STATUS_CURRENT},
+    {LM_PSTAT_TEMP_B0, LM_PSTAT_TEMP_B1, LM_API_STATUS_TEMP},
+    {LM_PSTAT_POS_B0, LM_PSTAT_POS_B3, LM_API_STATUS_POS},
+    {LM_PSTAT_SPD_B0, LM_PSTAT_SPD_B3, LM_API_STATUS_SPD},
+    {LM_PSTAT_FAULT, LM_PSTAT_FAULT, LM_API_STATUS_FAULT},
+    {LM_PSTAT_VOUT_B0, LM_PSTAT_VOUT_B1, LM_API_STATUS_VOUT},
+  };
+  for (const Range & range : ranges) {
+    if (code >= range.first && code <= range.last) {
+      return {range.api, static_cast<uint8_t>(code - range.first)};
+    }
+  }
+  return {0, 0};
+}
+}  // namespace
+
+template<uint32_t Id>
+Driver::Field * Driver::fieldFor()
+{
+  static_assert(fieldSlot(Id) != NO_FIELD, "Responses to this API are not cached");
+  return &fields_[fieldSlot(Id)];
+}
+
 namespace ConfigurationStates
 {
 enum ConfigurationState
@@ -49,6 +169,7 @@ enum ConfigurationState
   PGain,
   IGain,
   DGain,
+  PeriodicStatus,
   VerifiedParameters,
   Configured
 };
@@ -59,8 +180,10 @@ Driver::Driver(
   const std::shared_ptr<clearpath_ros2_socketcan_interface::SocketCANInterface> interface,
   std::shared_ptr<rclcpp::Node> nh,
   const uint8_t & device_number,
-  const std::string & device_name)
+  const std::string & device_name,
+  std::shared_ptr<CanTxBatch> tx_batch)
 : interface_(interface),
+  tx_batch_(tx_batch),
   nh_(nh),
   device_number_(device_number),
   device_name_(device_name),
@@ -71,11 +194,20 @@ Driver::Driver(
   gain_i_(0),
   gain_d_(0),
   encoder_cpr_(1),
-  gear_ratio_(1)
+  gear_ratio_(1),
+  sync_group_(0),
+  periodic_status_ms_(0),
+  periodic_status_received_(0),
+  pipelined_configuration_(false),
+  configuration_started_(0),
+  tx_frames_(0),
+  tx_bits_(0)
 {
+  memset(fields_, 0, sizeof(fields_));
+  memset(round_trip_, 0, sizeof(round_trip_));
 }
 
-void Driver::processMessage(const can_msgs::msg::Frame::SharedPtr received_msg)
+void Driver::processMessage(const can_msgs::msg::Frame::SharedPtr received_msg, int64_t stamp)
 {
   // If it's not our message, jump out.
   if (getDeviceNumber(*received_msg) != device_number_) {
@@ -87,31 +219,63 @@ void Driver::processMessage(const can_msgs::msg::Frame::SharedPtr received_msg)
     return;
   }
 
-  Field * field = nullptr;
+  if (!stamp) {
+    stamp = steadyNow();
+  }
+
   uint32_t received_api = getApi(*received_msg);
-  if ((received_api & CAN_MSGID_API_M & CAN_API_MC_CFG) == CAN_API_MC_CFG) {
-    field = cfgFieldForMessage(received_api);
-  } else if ((received_api & CAN_MSGID_API_M & CAN_API_MC_STATUS) == CAN_API_MC_STATUS) {
-    field = statusFieldForMessage(received_api);
-  } else if ((received_api & CAN_MSGID_API_M & CAN_API_MC_ICTRL) == CAN_API_MC_ICTRL) {
-    field = ictrlFieldForMessage(received_api);
-  } else if ((received_api & CAN_MSGID_API_M & CAN_API_MC_POS) == CAN_API_MC_POS) {
-    field = posFieldForMessage(received_api);
-  } else if ((received_api & CAN_MSGID_API_M & CAN_API_MC_VCOMP) == CAN_API_MC_VCOMP) {
-    field = vcompFieldForMessage(received_api);
-  } else if ((received_api & CAN_MSGID_API_M & CAN_API_MC_SPD) == CAN_API_MC_SPD) {
-    field = spdFieldForMessage(received_api);
-  } else if ((received_api & CAN_MSGID_API_M & CAN_API_MC_VOLTAGE) == CAN_API_MC_VOLTAGE) {
-    field = voltageFieldForMessage(received_api);
+  uint32_t periodic_status = (received_api - LM_API_PSTAT_DATA_S0) >> CAN_MSGID_API_S;
+  if (received_api >= LM_API_PSTAT_DATA_S0 && periodic_status < PERIODIC_STATUS_COUNT) {
+    processPeriodicStatus(periodic_status, *received_msg, stamp);
+    return;
   }
 
+  Field * field = fieldForApi(received_api);
+
   if (!field) {
     return;
   }
 
   // Copy the received data and mark that field as received.
-  std::copy(std::begin(received_msg->data), std::end(received_msg->data), std::begin(field->data));
+  std::copy_n(std::begin(received_msg->data), sizeof(field->data), std::begin(field->data));
   field->received = true;
+  field->sequence++;
+  field->stamp = stamp;
+
+  if (field->requested) {
+    RoundTrip & round_trip = round_trip_[apiClass(received_api)];
+    double elapsed = std::max<int64_t>(stamp - field->requested, 0) * 1e-9;
+    round_trip.responses++;
+    round_trip.total += elapsed;
+    round_trip.max = std::max(round_trip.max, elapsed);
+    field->requested = 0;
+  }
+}
+
+void Driver::processPeriodicStatus(
+  const uint8_t message, const can_msgs::msg::Frame & msg, const int64_t stamp)
+{
+  const uint8_t * layout = PERIODIC_STATUS_LAYOUT[message];
+  Field * previous = nullptr;
+  for (uint8_t i = 0; i < msg.dlc && i < PERIODIC_STATUS_LENGTH; i++) {
+    if (layout[i] == LM_PSTAT_END) {
+      break;
+    }
+    StatusByte status = statusByte(layout[i]);
+    if (status.api == 0) {
+      continue;
+    }
+    Field * field = fieldForApi(status.api);
+    field->data[status.offset] = msg.data[i];
+    field->received = true;
+    field->stamp = stamp;
+    // Fields span consecutive bytes; count each one once per message.
+    if (field != previous) {
+      field->sequence++;
+      previous = field;
+    }
+  }
+  periodic_status_received_ |= 1 << message;
 }
 
 double Driver::radPerSecToRpm() const
@@ -122,7 +286,19 @@ double Driver::radPerSecToRpm() const
 void Driver::sendId(const uint32_t id)
 {
   can_msgs::msg::Frame msg = getMsg(id);
-  interface_->queue(msg);
+  send(msg);
+}
+
+void Driver::sendRequest(const uint32_t id)
+{
+  Field * field = fieldForApi(id);
+  if (field) {
+    if (field->requested) {
+      round_trip_[apiClass(id)].missing++;
+    }
+    field->requested = steadyNow();
+  }
+  sendId(id);
 }
 
 void Driver::sendUint8(const uint32_t id, const uint8_t value)
@@ -133,7 +309,7 @@ void Driver::sendUint8(const uint32_t id, const uint8_t value)
   std::memcpy(data, &value, sizeof(uint8_t));
   std::copy(std::begin(data), std::end(data), std::begin(msg.data));
 
-  interface_->queue(msg);
+  send(msg);
 }
 
 void Driver::sendUint16(const uint32_t id, const uint16_t value)
@@ -144,10 +320,10 @@ void Driver::sendUint16(const uint32_t id, const uint16_t value)
   std::memcpy(data, &value, sizeof(uint16_t));
   std::copy(std::begin(data), std::end(data), std::begin(msg.data));
 
-  interface_->queue(msg);
+  send(msg);
 }
 
-void Driver::sendFixed8x8(const uint32_t id, const float value)
+void Driver::sendFixed8x8(const uint32_t id, const float value, const uint8_t group)
 {
   can_msgs::msg::Frame msg = getMsg(id);
   msg.dlc = sizeof(int16_t);
@@ -155,12 +331,16 @@ void Driver::sendFixed8x8(const uint32_t id, const float value)
 
   uint8_t data[8] = {0};
   std::memcpy(data, &output_value, sizeof(int16_t));
+  // A trailing group byte stages the value until a synchronous update.
+  if (group) {
+    data[msg.dlc++] = group;
+  }
   std::copy(std::begin(data), std::end(data), std::begin(msg.data));
 
-  interface_->queue(msg);
+  send(msg);
 }
 
-void Driver::sendFixed16x16(const uint32_t id, const double value)
+void Driver::sendFixed16x16(const uint32_t id, const double value, const uint8_t group)
 {
   can_msgs::msg::Frame msg = getMsg(id);
   msg.dlc = sizeof(int32_t);
@@ -168,9 +348,33 @@ void Driver::sendFixed16x16(const uint32_t id, const double value)
 
   uint8_t data[8] = {0};
   std::memcpy(data, &output_value, sizeof(int32_t));
+  if (group) {
+    data[msg.dlc++] = group;
+  }
   std::copy(std::begin(data), std::end(data), std::begin(msg.data));
 
-  interface_->queue(msg);
+  send(msg);
+}
+
+void Driver::send(const can_msgs::msg::Frame & msg)
+{
+  tx_frames_++;
+  tx_bits_ += frameBits(msg);
+
+  if (tx_batch_) {
+    tx_batch_->queue(msg);
+  } else {
+    interface_->queue(msg);
+  }
+}
+
+void Driver::sendBytes(const uint32_t id, const uint8_t * data, const uint8_t length)
+{
+  can_msgs::msg::Frame msg = getMsg(id);
+  msg.dlc = length;
+  std::copy(data, data + length, std::begin(msg.data));
+
+  send(msg);
 }
 
 can_msgs::msg::Frame Driver::getMsg(const uint32_t id)
@@ -184,12 +388,12 @@ can_msgs::msg::Frame Driver::getMsg(const uint32_t id)
   return msg;
 }
 
-uint32_t Driver::getApi(const can_msgs::msg::Frame msg)
+uint32_t Driver::getApi(const can_msgs::msg::Frame & msg)
 {
   return msg.id & (CAN_MSGID_FULL_M ^ CAN_MSGID_DEVNO_M);
 }
 
-uint32_t Driver::getDeviceNumber(const can_msgs::msg::Frame msg)
+uint32_t Driver::getDeviceNumber(const can_msgs::msg::Frame & msg)
 {
   return msg.id & CAN_MSGID_DEVNO_M;
 }
@@ -234,23 +438,49 @@ void Driver::setGearRatio(const float gear_ratio)
 
 void Driver::commandDutyCycle(const float cmd)
 {
-  sendFixed8x8((LM_API_VOLT_SET | device_number_), cmd);
+  sendFixed8x8((LM_API_VOLT_SET | device_number_), cmd, sync_group_);
 }
 
 void Driver::commandSpeed(const double cmd)
 {
   // Converting from rad/s to RPM through the gearbox.
-  sendFixed16x16((LM_API_SPD_SET | device_number_), (cmd * radPerSecToRpm()));
+  sendFixed16x16((LM_API_SPD_SET | device_number_), (cmd * radPerSecToRpm()), sync_group_);
+}
+
+void Driver::setSyncGroup(const uint8_t group)
+{
+  sync_group_ = group;
+}
+
+void Driver::sendSync(const uint8_t groups)
+{
+  // A system control broadcast, addressed to no manufacturer, device type or number.
+  sendUint8(CAN_MSGID_API_SYNC | CAN_MSGID_DEVNO_BCAST, groups);
 }
 
 void Driver::verifyParams()
 {
+  if (pipelined_configuration_ && state_ != ConfigurationState::Initializing) {
+    while (state_ < ConfigurationState::VerifiedParameters && stateVerified(state_)) {
+      state_ = nextState(state_);
+    }
+    // The next burst resends whatever is left, so there is nothing to request here.
+    if (state_ != ConfigurationState::VerifiedParameters) {
+      return;
+    }
+  }
+
   switch (state_) {
     case ConfigurationState::Initializing:
       RCLCPP_INFO(rclcpp::get_logger("rclcpp"),
         "Puma Motor Controller on %s (%i): starting to verify parameters.",
         device_name_.c_str(), device_number_);
       state_ = ConfigurationState::PowerFlag;
+      configuration_started_ = steadyNow();
+      // Readbacks cached before now may predate a power reset.
+      for (auto & field : fields_) {
+        field.configuring_sequence = field.sequence;
+      }
       break;
     case ConfigurationState::PowerFlag:
       if (lastPower() == 0) {
@@ -310,7 +540,8 @@ void Driver::verifyParams()
             "Puma Motor Controller on %s (%i): was set to a close loop control mode.",
             device_name_.c_str(), device_number_);
         } else {
-          state_ = ConfigurationState::VerifiedParameters;
+          state_ = periodic_status_ms_ ?
+            ConfigurationState::PeriodicStatus : ConfigurationState::VerifiedParameters;
           RCLCPP_INFO(rclcpp::get_logger("rclcpp"),
             "Puma Motor Controller on %s (%i): was set to voltage control mode.",
             device_name_.c_str(), device_number_);
@@ -365,7 +596,8 @@ void Driver::verifyParams()
       break;
     case ConfigurationState::DGain:
       if (verifyRaw16x16(getRawD(), gain_d_)) {
-        state_ = ConfigurationState::VerifiedParameters;
+        state_ = periodic_status_ms_ ?
+          ConfigurationState::PeriodicStatus : ConfigurationState::VerifiedParameters;
         RCLCPP_INFO(rclcpp::get_logger("rclcpp"),
           "Puma Motor Controller on %s (%i): D gain constant was set to %f and %f was requested.",
           device_name_.c_str(), device_number_, getD(), gain_d_);
@@ -386,11 +618,19 @@ void Driver::verifyParams()
         }
       }
       break;
+    case ConfigurationState::PeriodicStatus:
+      if (periodic_status_received_ == (1 << PERIODIC_STATUS_COUNT) - 1) {
+        state_ = ConfigurationState::VerifiedParameters;
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"),
+          "Puma Motor Controller on %s (%i): streaming periodic status every %i ms.",
+          device_name_.c_str(), device_number_, periodic_status_ms_);
+      }
+      break;
   }
   if (state_ == ConfigurationState::VerifiedParameters) {
     RCLCPP_INFO(rclcpp::get_logger("rclcpp"),
-      "Puma Motor Controller on %s (%i): all parameters verified.",
-      device_name_.c_str(), device_number_);
+      "Puma Motor Controller on %s (%i): all parameters verified in %.0f ms.",
+      device_name_.c_str(), device_number_, (steadyNow() - configuration_started_) * 1e-6);
     configured_ = true;
     state_ = ConfigurationState::Configured;
   }
@@ -398,7 +638,34 @@ void Driver::verifyParams()
 
 void Driver::configureParams()
 {
-  switch (state_) {
+  if (!pipelined_configuration_) {
+    configureState(state_);
+    return;
+  }
+
+  if (state_ == ConfigurationState::Initializing ||
+    state_ >= ConfigurationState::VerifiedParameters)
+  {
+    return;
+  }
+  // Skip the states already verified by readbacks of earlier bursts.
+  while (state_ < ConfigurationState::VerifiedParameters && stateVerified(state_)) {
+    state_ = nextState(state_);
+  }
+  for (uint8_t state = state_; state < ConfigurationState::VerifiedParameters;
+    state = nextState(state))
+  {
+    configureState(state);
+    uint32_t readback = readbackApi(state);
+    if (readback) {
+      sendId(readback | device_number_);
+    }
+  }
+}
+
+void Driver::configureState(const uint8_t state)
+{
+  switch (state) {
     case ConfigurationState::PowerFlag:
       sendUint8((LM_API_STATUS_POWER | device_number_), 1);
       break;
@@ -473,7 +740,122 @@ void Driver::configureParams()
           break;
       }
       break;
+    case ConfigurationState::PeriodicStatus:
+      // Lay out each message before enabling it.
+      for (uint8_t i = 0; i < PERIODIC_STATUS_COUNT; i++) {
+        sendBytes(
+          (LM_API_PSTAT_CFG_S0 + (i << CAN_MSGID_API_S)) | device_number_,
+          PERIODIC_STATUS_LAYOUT[i], PERIODIC_STATUS_LENGTH);
+        sendUint16(
+          (LM_API_PSTAT_PER_EN_S0 + (i << CAN_MSGID_API_S)) | device_number_,
+          periodic_status_ms_);
+      }
+      break;
+  }
+}
+
+uint8_t Driver::nextState(const uint8_t state) const
+{
+  bool gains = control_mode_ != clearpath_motor_msgs::msg::PumaStatus::MODE_VOLTAGE;
+  switch (state) {
+    case ConfigurationState::ControlMode:
+      if (gains) {
+        return ConfigurationState::PGain;
+      }
+      break;
+    case ConfigurationState::DGain:
+      break;
+    case ConfigurationState::PeriodicStatus:
+      return ConfigurationState::VerifiedParameters;
+    default:
+      return state + 1;
+  }
+  return periodic_status_ms_ ?
+         ConfigurationState::PeriodicStatus : ConfigurationState::VerifiedParameters;
+}
+
+uint32_t Driver::readbackApi(const uint8_t state) const
+{
+  // Readbacks of the gains depend on the control mode.
+  uint8_t mode_index = 0;
+  switch (control_mode_) {
+    case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
+      mode_index = 0;
+      break;
+    case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
+      mode_index = 1;
+      break;
+    default:
+      mode_index = 2;
+      break;
   }
+  static constexpr uint32_t P_GAIN[] = {LM_API_ICTRL_PC, LM_API_POS_PC, LM_API_SPD_PC};
+  static constexpr uint32_t I_GAIN[] = {LM_API_ICTRL_IC, LM_API_POS_IC, LM_API_SPD_IC};
+  static constexpr uint32_t D_GAIN[] = {LM_API_ICTRL_DC, LM_API_POS_DC, LM_API_SPD_DC};
+
+  switch (state) {
+    case ConfigurationState::PowerFlag:
+      return LM_API_STATUS_POWER;
+    case ConfigurationState::EncoderPosRef:
+      return LM_API_POS_REF;
+    case ConfigurationState::EncoderSpdRef:
+      return LM_API_SPD_REF;
+    case ConfigurationState::EncoderCounts:
+      return LM_API_CFG_ENC_LINES;
+    case ConfigurationState::ClosedLoop:
+    case ConfigurationState::ControlMode:
+      return LM_API_STATUS_CMODE;
+    case ConfigurationState::PGain:
+      return P_GAIN[mode_index];
+    case ConfigurationState::IGain:
+      return I_GAIN[mode_index];
+    case ConfigurationState::DGain:
+      return D_GAIN[mode_index];
+  }
+  return 0;
+}
+
+bool Driver::stateVerified(const uint8_t state)
+{
+  if (state == ConfigurationState::PeriodicStatus) {
+    return periodic_status_received_ == (1 << PERIODIC_STATUS_COUNT) - 1;
+  }
+
+  // Only a readback received since configuration began reflects what was set. Comparing
+  // sequences rather than stamps leaves this independent of where receive times come from.
+  Field * field = fieldForApi(readbackApi(state));
+  if (!field || field->sequence == field->configuring_sequence) {
+    return false;
+  }
+
+  switch (state) {
+    case ConfigurationState::PowerFlag:
+      return lastPower() == 0;
+    case ConfigurationState::EncoderPosRef:
+      return posEncoderRef() == LM_REF_ENCODER;
+    case ConfigurationState::EncoderSpdRef:
+      return spdEncoderRef() == LM_REF_QUAD_ENCODER;
+    case ConfigurationState::EncoderCounts:
+      return encoderCounts() == encoder_cpr_;
+    case ConfigurationState::ClosedLoop:
+      // The burst enables speed mode, then the control mode, so either one reads back.
+      return lastMode() == clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED ||
+             lastMode() == control_mode_;
+    case ConfigurationState::ControlMode:
+      return lastMode() == control_mode_;
+    case ConfigurationState::PGain:
+      return verifyRaw16x16(getRawP(), gain_p_);
+    case ConfigurationState::IGain:
+      return verifyRaw16x16(getRawI(), gain_i_);
+    case ConfigurationState::DGain:
+      return verifyRaw16x16(getRawD(), gain_d_);
+  }
+  return false;
+}
+
+void Driver::setPipelinedConfiguration(const bool pipelined)
+{
+  pipelined_configuration_ = pipelined;
 }
 
 bool Driver::isConfigured() const
@@ -531,71 +913,105 @@ void Driver::setMode(const uint8_t mode, const double p, const double i, const d
   }
 }
 
+double Driver::feedbackAge()
+{
+  Field * position = fieldFor<LM_API_STATUS_POS>();
+  Field * speed = fieldFor<LM_API_STATUS_SPD>();
+  if (position->sequence == 0 || speed->sequence == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return (steadyNow() - std::min(position->stamp, speed->stamp)) * 1e-9;
+}
+
+uint32_t Driver::feedbackSequence()
+{
+  return std::min(
+    fieldFor<LM_API_STATUS_POS>()->sequence, fieldFor<LM_API_STATUS_SPD>()->sequence);
+}
+
+void Driver::clearBusStats()
+{
+  memset(round_trip_, 0, sizeof(round_trip_));
+  tx_frames_ = 0;
+  tx_bits_ = 0;
+}
+
+uint32_t Driver::frameBits(const can_msgs::msg::Frame & msg)
+{
+  // Start of frame through CRC is subject to stuffing, 34 bits of it with a standard id and
+  // 54 with an extended one. The worst case adds a bit after every four. CRC delimiter, ACK,
+  // end of frame and interframe space add 13 unstuffed bits.
+  uint32_t stuffed = (msg.is_extended ? 54 : 34) + 8 * msg.dlc;
+  return stuffed + (stuffed - 1) / 4 + 13;
+}
+
+void Driver::setPeriodicStatus(const uint16_t period_ms)
+{
+  periodic_status_ms_ = period_ms;
+  if (configured_) {
+    resetConfiguration();
+  }
+}
+
 void Driver::clearMsgCache()
 {
   // Set it all to zero, which will in part clear
   // the boolean flags to be false.
-  memset(voltage_fields_, 0, sizeof(voltage_fields_));
-  memset(spd_fields_, 0, sizeof(spd_fields_));
-  memset(vcomp_fields_, 0, sizeof(vcomp_fields_));
-  memset(pos_fields_, 0, sizeof(pos_fields_));
-  memset(ictrl_fields_, 0, sizeof(ictrl_fields_));
-  memset(status_fields_, 0, sizeof(status_fields_));
-  memset(cfg_fields_, 0, sizeof(cfg_fields_));
+  memset(fields_, 0, sizeof(fields_));
 }
 
 void Driver::requestStatusMessages()
 {
-  sendId(LM_API_STATUS_POWER | device_number_);
+  sendRequest(LM_API_STATUS_POWER | device_number_);
 }
 
 void Driver::requestFeedbackMessages()
 {
-  sendId(LM_API_STATUS_VOLTOUT | device_number_);
-  sendId(LM_API_STATUS_CURRENT | device_number_);
-  sendId(LM_API_STATUS_POS | device_number_);
-  sendId(LM_API_STATUS_SPD | device_number_);
-  sendId(LM_API_SPD_SET | device_number_);
+  sendRequest(LM_API_STATUS_VOLTOUT | device_number_);
+  sendRequest(LM_API_STATUS_CURRENT | device_number_);
+  sendRequest(LM_API_STATUS_POS | device_number_);
+  sendRequest(LM_API_STATUS_SPD | device_number_);
+  sendRequest(LM_API_SPD_SET | device_number_);
 }
 void Driver::requestFeedbackDutyCycle()
 {
-  sendId(LM_API_STATUS_VOLTOUT | device_number_);
+  sendRequest(LM_API_STATUS_VOLTOUT | device_number_);
 }
 
 void Driver::requestFeedbackCurrent()
 {
-  sendId(LM_API_STATUS_CURRENT | device_number_);
+  sendRequest(LM_API_STATUS_CURRENT | device_number_);
 }
 
 void Driver::requestFeedbackPosition()
 {
-  sendId(LM_API_STATUS_POS | device_number_);
+  sendRequest(LM_API_STATUS_POS | device_number_);
 }
 
 void Driver::requestFeedbackSpeed()
 {
-  sendId(LM_API_STATUS_SPD | device_number_);
+  sendRequest(LM_API_STATUS_SPD | device_number_);
 }
 
 void Driver::requestFeedbackPowerState()
 {
-  sendId(LM_API_STATUS_POWER | device_number_);
+  sendRequest(LM_API_STATUS_POWER | device_number_);
 }
 
 void Driver::requestFeedbackSetpoint()
 {
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      sendId(LM_API_ICTRL_SET | device_number_);
+      sendRequest(LM_API_ICTRL_SET | device_number_);
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      sendId(LM_API_POS_SET | device_number_);
+      sendRequest(LM_API_POS_SET | device_number_);
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      sendId(LM_API_SPD_SET | device_number_);
+      sendRequest(LM_API_SPD_SET | device_number_);
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_VOLTAGE:
-      sendId(LM_API_VOLT_SET | device_number_);
+      sendRequest(LM_API_VOLT_SET | device_number_);
       break;
   }
 }
@@ -604,6 +1020,7 @@ void Driver::resetConfiguration()
 {
   configured_ = false;
   state_ = ConfigurationState::Initializing;
+  periodic_status_received_ = 0;
 }
 
 void Driver::updateGains()
@@ -614,67 +1031,67 @@ void Driver::updateGains()
 
 bool Driver::receivedDutyCycle()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_VOLTOUT)));
+  Field * field = fieldFor<LM_API_STATUS_VOLTOUT>();
   return field->received;
 }
 
 bool Driver::receivedBusVoltage()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_VOLTBUS)));
+  Field * field = fieldFor<LM_API_STATUS_VOLTBUS>();
   return field->received;
 }
 
 bool Driver::receivedCurrent()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_CURRENT)));
+  Field * field = fieldFor<LM_API_STATUS_CURRENT>();
   return field->received;
 }
 
 bool Driver::receivedPosition()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_POS)));
+  Field * field = fieldFor<LM_API_STATUS_POS>();
   return field->received;
 }
 
 bool Driver::receivedSpeed()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_SPD)));
+  Field * field = fieldFor<LM_API_STATUS_SPD>();
   return field->received;
 }
 
 bool Driver::receivedFault()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_FAULT)));
+  Field * field = fieldFor<LM_API_STATUS_FAULT>();
   return field->received;
 }
 
 bool Driver::receivedPower()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_POWER)));
+  Field * field = fieldFor<LM_API_STATUS_POWER>();
   return field->received;
 }
 
 bool Driver::receivedMode()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_CMODE)));
+  Field * field = fieldFor<LM_API_STATUS_CMODE>();
   return field->received;
 }
 
 bool Driver::receivedOutVoltage()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_VOUT)));
+  Field * field = fieldFor<LM_API_STATUS_VOUT>();
   return field->received;
 }
 
 bool Driver::receivedTemperature()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_TEMP)));
+  Field * field = fieldFor<LM_API_STATUS_TEMP>();
   return field->received;
 }
 
 bool Driver::receivedAnalogInput()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(CPR_API_STATUS_ANALOG)));
+  Field * field = fieldFor<CPR_API_STATUS_ANALOG>();
   return field->received;
 }
 
@@ -701,101 +1118,101 @@ bool Driver::receivedSetpoint()
 
 bool Driver::receivedSpeedSetpoint()
 {
-  Field * field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_SET)));
+  Field * field = fieldFor<LM_API_SPD_SET>();
   return field->received;
 }
 
 bool Driver::receivedDutyCycleSetpoint()
 {
-  Field * field = voltageFieldForMessage(getApi(getMsg(LM_API_VOLT_SET)));
+  Field * field = fieldFor<LM_API_VOLT_SET>();
   return field->received;
 }
 
 bool Driver::receivedCurrentSetpoint()
 {
-  Field * field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_SET)));
+  Field * field = fieldFor<LM_API_ICTRL_SET>();
   return field->received;
 }
 
 bool Driver::receivedPositionSetpoint()
 {
-  Field * field = posFieldForMessage(getApi(getMsg(LM_API_POS_SET)));
+  Field * field = fieldFor<LM_API_POS_SET>();
   return field->received;
 }
 
 float Driver::lastDutyCycle()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_VOLTOUT)));
+  Field * field = fieldFor<LM_API_STATUS_VOLTOUT>();
   field->received = false;
   return field->interpretFixed8x8() / 128.0;
 }
 
 float Driver::lastBusVoltage()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_VOLTBUS)));
+  Field * field = fieldFor<LM_API_STATUS_VOLTBUS>();
   field->received = false;
   return field->interpretFixed8x8();
 }
 
 float Driver::lastCurrent()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_CURRENT)));
+  Field * field = fieldFor<LM_API_STATUS_CURRENT>();
   field->received = false;
   return field->interpretFixed8x8();
 }
 
 double Driver::lastPosition()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_POS)));
+  Field * field = fieldFor<LM_API_STATUS_POS>();
   field->received = false;
   return field->interpretFixed16x16() * ((2 * M_PI) / gear_ratio_);  // Convert rev to rad
 }
 
 double Driver::lastSpeed()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_SPD)));
+  Field * field = fieldFor<LM_API_STATUS_SPD>();
   field->received = false;
   return field->interpretFixed16x16() * ((2 * M_PI) / (gear_ratio_ * 60));  // Convert RPM to rad/s
 }
 
 uint8_t Driver::lastFault()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_FAULT)));
+  Field * field = fieldFor<LM_API_STATUS_FAULT>();
   field->received = false;
   return field->data[0];
 }
 
 uint8_t Driver::lastPower()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_POWER)));
+  Field * field = fieldFor<LM_API_STATUS_POWER>();
   field->received = false;
   return field->data[0];
 }
 
 uint8_t Driver::lastMode()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_CMODE)));
+  Field * field = fieldFor<LM_API_STATUS_CMODE>();
   field->received = false;
   return field->data[0];
 }
 
 float Driver::lastOutVoltage()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_VOUT)));
+  Field * field = fieldFor<LM_API_STATUS_VOUT>();
   field->received = false;
   return field->interpretFixed8x8();
 }
 
 float Driver::lastTemperature()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(LM_API_STATUS_TEMP)));
+  Field * field = fieldFor<LM_API_STATUS_TEMP>();
   field->received = false;
   return field->interpretFixed8x8();
 }
 
 float Driver::lastAnalogInput()
 {
-  Field * field = statusFieldForMessage(getApi(getMsg(CPR_API_STATUS_ANALOG)));
+  Field * field = fieldFor<CPR_API_STATUS_ANALOG>();
   field->received = false;
   return field->interpretFixed8x8();
 }
@@ -822,47 +1239,47 @@ double Driver::lastSetpoint()
 }
 double Driver::statusSpeedGet()
 {
-  Field * field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_SET)));
+  Field * field = fieldFor<LM_API_SPD_SET>();
   field->received = false;
   return field->interpretFixed16x16() * ((2 * M_PI) / (gear_ratio_ * 60));  // Convert RPM to rad/s
 }
 
 float Driver::statusDutyCycleGet()
 {
-  Field * field = voltageFieldForMessage(getApi(getMsg(LM_API_VOLT_SET)));
+  Field * field = fieldFor<LM_API_VOLT_SET>();
   field->received = false;
   return field->interpretFixed8x8() / 128.0;
 }
 
 float Driver::statusCurrentGet()
 {
-  Field * field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_SET)));
+  Field * field = fieldFor<LM_API_ICTRL_SET>();
   field->received = false;
   return field->interpretFixed8x8();
 }
 
 double Driver::statusPositionGet()
 {
-  Field * field = posFieldForMessage(getApi(getMsg(LM_API_POS_SET)));
+  Field * field = fieldFor<LM_API_POS_SET>();
   field->received = false;
   return field->interpretFixed16x16() * (( 2 * M_PI) / gear_ratio_);  // Convert rev to rad
 }
 
 uint8_t Driver::posEncoderRef()
 {
-  Field * field = posFieldForMessage(getApi(getMsg(LM_API_POS_REF)));
+  Field * field = fieldFor<LM_API_POS_REF>();
   return field->data[0];
 }
 
 uint8_t Driver::spdEncoderRef()
 {
-  Field * field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_REF)));
+  Field * field = fieldFor<LM_API_SPD_REF>();
   return field->data[0];
 }
 
 uint16_t Driver::encoderCounts()
 {
-  Field * field = cfgFieldForMessage(getApi(getMsg(LM_API_CFG_ENC_LINES)));
+  Field * field = fieldFor<LM_API_CFG_ENC_LINES>();
   return static_cast<uint16_t>(field->data[0]) | static_cast<uint16_t>(field->data[1] << 8);
 }
 
@@ -871,13 +1288,13 @@ double Driver::getP()
   Field * field;
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_PC)));
+      field = fieldFor<LM_API_ICTRL_PC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      field = posFieldForMessage(getApi(getMsg(LM_API_POS_PC)));
+      field = fieldFor<LM_API_POS_PC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_PC)));
+      field = fieldFor<LM_API_SPD_PC>();
       break;
   }
   return field->interpretFixed16x16();
@@ -888,13 +1305,13 @@ double Driver::getI()
   Field * field;
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_IC)));
+      field = fieldFor<LM_API_ICTRL_IC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      field = posFieldForMessage(getApi(getMsg(LM_API_POS_IC)));
+      field = fieldFor<LM_API_POS_IC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_IC)));
+      field = fieldFor<LM_API_SPD_IC>();
       break;
   }
   return field->interpretFixed16x16();
@@ -905,13 +1322,13 @@ double Driver::getD()
   Field * field;
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_DC)));
+      field = fieldFor<LM_API_ICTRL_DC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      field = posFieldForMessage(getApi(getMsg(LM_API_POS_DC)));
+      field = fieldFor<LM_API_POS_DC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_DC)));
+      field = fieldFor<LM_API_SPD_DC>();
       break;
   }
   return field->interpretFixed16x16();
@@ -922,13 +1339,13 @@ uint8_t * Driver::getRawP()
   Field * field;
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_PC)));
+      field = fieldFor<LM_API_ICTRL_PC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      field = posFieldForMessage(getApi(getMsg(LM_API_POS_PC)));
+      field = fieldFor<LM_API_POS_PC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_PC)));
+      field = fieldFor<LM_API_SPD_PC>();
       break;
   }
   return field->data;
@@ -939,13 +1356,13 @@ uint8_t * Driver::getRawI()
   Field * field;
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_IC)));
+      field = fieldFor<LM_API_ICTRL_IC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      field = posFieldForMessage(getApi(getMsg(LM_API_POS_IC)));
+      field = fieldFor<LM_API_POS_IC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_IC)));
+      field = fieldFor<LM_API_SPD_IC>();
       break;
   }
   return field->data;
@@ -956,58 +1373,23 @@ uint8_t * Driver::getRawD()
   Field * field;
   switch (control_mode_) {
     case clearpath_motor_msgs::msg::PumaStatus::MODE_CURRENT:
-      field = ictrlFieldForMessage(getApi(getMsg(LM_API_ICTRL_DC)));
+      field = fieldFor<LM_API_ICTRL_DC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_POSITION:
-      field = posFieldForMessage(getApi(getMsg(LM_API_POS_DC)));
+      field = fieldFor<LM_API_POS_DC>();
       break;
     case clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED:
-      field = spdFieldForMessage(getApi(getMsg(LM_API_SPD_DC)));
+      field = fieldFor<LM_API_SPD_DC>();
       break;
   }
   return field->data;
 }
 
-Driver::Field * Driver::voltageFieldForMessage(uint32_t api)
-{
-  uint32_t voltage_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &voltage_fields_[voltage_field_index];
-}
-
-Driver::Field * Driver::spdFieldForMessage(uint32_t api)
-{
-  uint32_t spd_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &spd_fields_[spd_field_index];
-}
-
-Driver::Field * Driver::vcompFieldForMessage(uint32_t api)
-{
-  uint32_t vcomp_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &vcomp_fields_[vcomp_field_index];
-}
-
-Driver::Field * Driver::posFieldForMessage(uint32_t api)
-{
-  uint32_t pos_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &pos_fields_[pos_field_index];
-}
-
-Driver::Field * Driver::ictrlFieldForMessage(uint32_t api)
-{
-  uint32_t ictrl_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &ictrl_fields_[ictrl_field_index];
-}
-
-Driver::Field * Driver::statusFieldForMessage(uint32_t api)
-{
-  uint32_t status_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &status_fields_[status_field_index];
-}
-
-Driver::Field * Driver::cfgFieldForMessage(uint32_t api)
+Driver::Field * Driver::fieldForApi(uint32_t api)
 {
-  uint32_t cfg_field_index = (api & CAN_MSGID_API_ID_M) >> CAN_MSGID_API_S;
-  return &cfg_fields_[cfg_field_index];
+  static_assert(FIELD_SLOTS.count == FIELD_COUNT, "Field storage does not match slot table");
+  int8_t slot = fieldSlot(api);
+  return slot == NO_FIELD ? nullptr : &fields_[slot];
 }
 
 }  // namespace puma_motor_driver
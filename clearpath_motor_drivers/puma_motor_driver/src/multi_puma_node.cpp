@@ -23,15 +23,38 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 */
 #include "puma_motor_driver/multi_puma_node.hpp"
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
 MultiPumaNode::MultiPumaNode(const std::string node_name)
 :Node(node_name),
   active_(false),
   status_count_(0),
-  desired_mode_(clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED)
+  desired_mode_(clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED),
+  control_thread_running_(false),
+  overruns_(0),
+  rx_frames_(0),
+  rx_bits_(0)
 {
   // Parameters
+  this->declare_parameter("batch_tx", false);
+  this->declare_parameter("bitrate", 1000000);
   this->declare_parameter("canbus_dev", "vcan0");
+  this->declare_parameter("control_thread.enabled", false);
+  this->declare_parameter("control_thread.priority", 0);
+  this->declare_parameter("control_thread.cpu", -1);
   this->declare_parameter("encoder_cpr", 1024);
+  this->declare_parameter("feedback_timeout", 0.0);
   this->declare_parameter("frequency", 25);
   this->declare_parameter("gain.p", 0.1);
   this->declare_parameter("gain.i", 0.01);
@@ -40,9 +63,19 @@ MultiPumaNode::MultiPumaNode(const std::string node_name)
   this->declare_parameter("joint_can_ids", std::vector<int64_t>());
   this->declare_parameter("joint_directions", std::vector<int64_t>());
   this->declare_parameter("joint_names", std::vector<std::string>());
+  this->declare_parameter("periodic_status", 0);
+  this->declare_parameter("pipelined_configuration", false);
+  this->declare_parameter("raw_rx", false);
+  this->declare_parameter("sync_group", 0);
 
+  this->get_parameter("batch_tx", batch_tx_);
+  this->get_parameter("bitrate", bitrate_);
   this->get_parameter("canbus_dev", canbus_dev_);
+  this->get_parameter("control_thread.enabled", control_thread_enabled_);
+  this->get_parameter("control_thread.priority", control_thread_priority_);
+  this->get_parameter("control_thread.cpu", control_thread_cpu_);
   this->get_parameter("encoder_cpr", encoder_cpr_);
+  this->get_parameter("feedback_timeout", feedback_timeout_);
   this->get_parameter("frequency", freq_);
   this->get_parameter("gain.p", gain_p_);
   this->get_parameter("gain.i", gain_i_);
@@ -51,13 +84,27 @@ MultiPumaNode::MultiPumaNode(const std::string node_name)
   joint_can_ids_ = this->get_parameter("joint_can_ids").as_integer_array();
   joint_directions_ = this->get_parameter("joint_directions").as_integer_array();
   joint_names_ = this->get_parameter("joint_names").as_string_array();
+  this->get_parameter("periodic_status", periodic_status_);
+  this->get_parameter("pipelined_configuration", pipelined_configuration_);
+  this->get_parameter("raw_rx", raw_rx_);
+  this->get_parameter("sync_group", sync_group_);
+  // Unless set, feedback goes stale after a few missed control periods
+  if (feedback_timeout_ <= 0.0) {
+    feedback_timeout_ = FEEDBACK_TIMEOUT_PERIODS / static_cast<double>(freq_);
+  }
+  if (sync_group_ < 0 || sync_group_ > 0xff) {
+    RCLCPP_WARN(this->get_logger(), "sync_group must be a bit mask in [0, 255], disabling.");
+    sync_group_ = 0;
+  }
 
   RCLCPP_INFO(
     this->get_logger(),
-    "Gear Ratio %f\nEncoder CPR %d\nFrequency %d\nGain PID %f,%f,%f\nCANBus Device %s",
+    "Gear Ratio %f\nEncoder CPR %d\nFrequency %d\nFeedback Timeout %f\nGain PID %f,%f,%f\n"
+    "CANBus Device %s",
     gear_ratio_,
     encoder_cpr_,
     freq_,
+    feedback_timeout_,
     gain_p_,
     gain_i_,
     gain_d_,
@@ -87,26 +134,60 @@ MultiPumaNode::MultiPumaNode(const std::string node_name)
   status_pub_ = this->create_publisher<clearpath_motor_msgs::msg::PumaMultiStatus>(
     "platform/puma/status",
     rclcpp::SensorDataQoS());
+  diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+    "diagnostics", rclcpp::QoS(10));
+  metrics_pub_ = this->create_publisher<std_msgs::msg::Float64MultiArray>(
+    "platform/puma/can_metrics", rclcpp::SensorDataQoS());
 
   node_handle_ = std::shared_ptr<rclcpp::Node>(this, [](rclcpp::Node *){});
 
   // Socket
-  interface_.reset(new clearpath_ros2_socketcan_interface::SocketCANInterface(
-    canbus_dev_, node_handle_));
+  if (batch_tx_) {
+    tx_batch_ = std::make_shared<puma_motor_driver::CanTxBatch>(canbus_dev_);
+    if (!tx_batch_->isOpen()) {
+      RCLCPP_WARN(this->get_logger(), "Batched transmit unavailable, using the send timer.");
+      tx_batch_.reset();
+    }
+  }
 
-  interface_->startSendTimer(1);
+  // Frames sent through the interface loop back to the raw socket as if the controllers had
+  // answered, so raw receive is only used together with batched transmit.
+  if (raw_rx_ && !tx_batch_) {
+    RCLCPP_WARN(this->get_logger(), "Raw receive needs batch_tx, using the SocketCAN interface.");
+  } else if (raw_rx_) {
+    std::vector<uint8_t> device_numbers(joint_can_ids_.begin(), joint_can_ids_.end());
+    rx_batch_ = std::make_unique<puma_motor_driver::CanRxBatch>(canbus_dev_, device_numbers);
+    if (!rx_batch_->isOpen()) {
+      RCLCPP_WARN(this->get_logger(), "Raw receive unavailable, using the SocketCAN interface.");
+      rx_batch_.reset();
+    }
+  }
+
+  // The SocketCAN interface is only needed when the raw sockets aren't both open.
+  if (!rx_batch_) {
+    interface_.reset(new clearpath_ros2_socketcan_interface::SocketCANInterface(
+      canbus_dev_, node_handle_));
+    interface_->startSendTimer(1);
+  }
 
   for (uint8_t i = 0; i < joint_names_.size(); i++) {
     drivers_.push_back(puma_motor_driver::Driver(
       interface_,
       node_handle_,
       joint_can_ids_[i],
-      joint_names_[i]
+      joint_names_[i],
+      tx_batch_
     ));
   }
 
+  device_drivers_.assign(drivers_);
+  for (auto & driver : drivers_) {
+    name_drivers_[driver.deviceName()] = &driver;
+  }
+
   recv_msg_.reset(new can_msgs::msg::Frame());
   feedback_msg_.drivers_feedback.resize(drivers_.size());
+  feedback_sequences_.resize(drivers_.size(), 0);
   status_msg_.drivers.resize(drivers_.size());
 
   uint8_t i = 0;
@@ -115,44 +196,126 @@ MultiPumaNode::MultiPumaNode(const std::string node_name)
     driver.setEncoderCPR(encoder_cpr_);
     driver.setGearRatio(gear_ratio_ * joint_directions_[i]);
     driver.setMode(desired_mode_, gain_p_, gain_i_, gain_d_);
+    driver.setPeriodicStatus(periodic_status_);
+    driver.setPipelinedConfiguration(pipelined_configuration_);
+    driver.setSyncGroup(sync_group_);
     i++;
   }
 
-  run_timer_ = this->create_wall_timer(
-    std::chrono::milliseconds(1000 / freq_), std::bind(&MultiPumaNode::run, this));
+  bus_stats_start_ = this->get_clock()->now();
+  bus_stats_timer_ = this->create_wall_timer(
+    std::chrono::seconds(1), std::bind(&MultiPumaNode::publishBusStats, this));
+
+  if (control_thread_enabled_) {
+    control_thread_running_ = true;
+    control_thread_ = std::thread(&MultiPumaNode::controlThread, this);
+  } else {
+    run_timer_ = this->create_wall_timer(
+      std::chrono::nanoseconds(1000000000 / freq_), std::bind(&MultiPumaNode::run, this));
+  }
 }
 
-bool MultiPumaNode::getFeedback()
+MultiPumaNode::~MultiPumaNode()
 {
-  // Check All Fields Received
-  uint8_t received = 0;
-  for (auto & driver : drivers_) {
-    received |= driver.receivedDutyCycle() << FeedbackBit::DutyCycle;
-    received |= driver.receivedCurrent() << FeedbackBit::Current;
-    received |= driver.receivedPosition() << FeedbackBit::Position;
-    received |= driver.receivedSpeed() << FeedbackBit::Speed;
-    received |= driver.receivedSetpoint() << FeedbackBit::Setpoint;
+  control_thread_running_ = false;
+  if (control_thread_.joinable()) {
+    control_thread_.join();
+  }
+}
+
+void MultiPumaNode::controlThread()
+{
+  if (control_thread_priority_ > 0) {
+    sched_param param;
+    param.sched_priority = control_thread_priority_;
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+      RCLCPP_WARN(this->get_logger(),
+        "Failed to set control thread SCHED_FIFO priority %d: %s",
+        control_thread_priority_, strerror(result));
+    }
   }
 
-  if (received != (1 << FeedbackBit::Count) - 1) {
-    return false;
+  if (control_thread_cpu_ >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(control_thread_cpu_, &cpus);
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0) {
+      RCLCPP_WARN(this->get_logger(),
+        "Failed to pin control thread to CPU %d: %s", control_thread_cpu_, strerror(result));
+    }
   }
 
+  int timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if (timer < 0) {
+    RCLCPP_ERROR(this->get_logger(), "Failed to create control timer: %s", strerror(errno));
+    return;
+  }
+
+  // Deadlines are absolute, so time spent in run() does not push later cycles back.
+  int64_t period_ns = 1000000000 / freq_;
+  struct itimerspec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec.it_value);
+  spec.it_interval.tv_sec = period_ns / 1000000000;
+  spec.it_interval.tv_nsec = period_ns % 1000000000;
+  spec.it_value.tv_nsec += spec.it_interval.tv_nsec;
+  spec.it_value.tv_sec += spec.it_interval.tv_sec + spec.it_value.tv_nsec / 1000000000;
+  spec.it_value.tv_nsec %= 1000000000;
+  timerfd_settime(timer, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+  RCLCPP_INFO(this->get_logger(), "Control thread running at %d Hz.", freq_);
+
+  while (control_thread_running_ && rclcpp::ok()) {
+    // Blocks until the next deadline; more than one expiration means deadlines were missed.
+    uint64_t expirations = 0;
+    if (read(timer, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+      if (errno == EINTR) {
+        continue;
+      }
+      RCLCPP_ERROR(this->get_logger(), "Control timer failed: %s", strerror(errno));
+      break;
+    }
+    if (expirations > 1) {
+      overruns_ += expirations - 1;
+      RCLCPP_WARN_THROTTLE(this->get_logger(), *this->get_clock(), 1000,
+        "Control thread missed %" PRIu64 " deadlines, %" PRIu64 " in total.",
+        expirations - 1, overruns_);
+    }
+    run();
+  }
+  close(timer);
+}
+
+bool MultiPumaNode::getFeedback()
+{
+  bool any_fresh = false;
   uint8_t feedback_index = 0;
   for (auto & driver : drivers_) {
     clearpath_motor_msgs::msg::PumaFeedback * f = &feedback_msg_.drivers_feedback[feedback_index];
     f->device_number = driver.deviceNumber();
     f->device_name = driver.deviceName();
-    f->duty_cycle = driver.lastDutyCycle();
-    f->current = driver.lastCurrent();
-    f->travel = driver.lastPosition();
-    f->speed = driver.lastSpeed();
-    f->setpoint = driver.lastSetpoint();
+
+    double age = driver.feedbackAge();
+    if (age > feedback_timeout_) {
+      f->duty_cycle = std::numeric_limits<double>::quiet_NaN();
+      f->current = std::numeric_limits<double>::quiet_NaN();
+      f->travel = std::numeric_limits<double>::quiet_NaN();
+      f->speed = std::numeric_limits<double>::quiet_NaN();
+      f->setpoint = std::numeric_limits<double>::quiet_NaN();
+    } else {
+      f->duty_cycle = driver.lastDutyCycle();
+      f->current = driver.lastCurrent();
+      f->travel = driver.lastPosition();
+      f->speed = driver.lastSpeed();
+      f->setpoint = driver.lastSetpoint();
+      any_fresh = true;
+    }
 
     feedback_index++;
   }
   feedback_msg_.header.stamp = this->get_clock()->now();
-  return true;
+  return any_fresh;
 }
 
 bool MultiPumaNode::getStatus()
@@ -215,19 +378,136 @@ void MultiPumaNode::publishStatus()
   }
 }
 
+void MultiPumaNode::publishBusStats()
+{
+  static const char * const API_CLASS_NAMES[puma_motor_driver::Driver::API_CLASS_COUNT] = {
+    "voltage", "speed", "vcomp", "position", "current", "status", "pstat", "config"};
+
+  std::lock_guard<std::mutex> lock(driver_mutex_);
+
+  rclcpp::Time now = this->get_clock()->now();
+  double elapsed = (now - bus_stats_start_).seconds();
+  if (elapsed <= 0.0) {
+    return;
+  }
+
+  uint64_t tx_frames = 0;
+  uint64_t tx_bits = 0;
+  for (auto & driver : drivers_) {
+    tx_frames += driver.txFrames();
+    tx_bits += driver.txBits();
+  }
+  double load = (tx_bits + rx_bits_) / elapsed / bitrate_;
+  uint64_t tx_dropped = tx_batch_ ? tx_batch_->droppedFrames() : 0;
+
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.name = "Puma CAN bus";
+  status.hardware_id = canbus_dev_;
+  auto add_value = [&status](const std::string & key, double value)
+    {
+      diagnostic_msgs::msg::KeyValue key_value;
+      key_value.key = key;
+      key_value.value = std::to_string(value);
+      status.values.push_back(key_value);
+    };
+  add_value("TX frames/s", tx_frames / elapsed);
+  add_value("TX bits/s", tx_bits / elapsed);
+  add_value("RX frames/s", rx_frames_ / elapsed);
+  add_value("RX bits/s", rx_bits_ / elapsed);
+  add_value("Bus load", load);
+  add_value("TX dropped frames", tx_dropped);
+
+  // Compact metrics: bus TX/RX frames and bits per second, load and dropped TX frames, then
+  // for each driver its mean and maximum round trip time in seconds and missing responses.
+  std_msgs::msg::Float64MultiArray metrics;
+  metrics.data = {
+    tx_frames / elapsed, tx_bits / elapsed, rx_frames_ / elapsed, rx_bits_ / elapsed, load,
+    static_cast<double>(tx_dropped)};
+
+  uint32_t missing = 0;
+  uint32_t stale = 0;
+  for (size_t d = 0; d < drivers_.size(); d++) {
+    auto & driver = drivers_[d];
+    double age = driver.feedbackAge();
+    uint32_t sequence = driver.feedbackSequence();
+    add_value(driver.deviceName() + " feedback age (ms)", 1e3 * age);
+    add_value(
+      driver.deviceName() + " feedback rate (Hz)", (sequence - feedback_sequences_[d]) / elapsed);
+    feedback_sequences_[d] = sequence;
+    if (age > feedback_timeout_) {
+      stale++;
+    }
+
+    puma_motor_driver::Driver::RoundTrip total{};
+    for (uint8_t i = 0; i < puma_motor_driver::Driver::API_CLASS_COUNT; i++) {
+      const auto & round_trip = driver.roundTrip(i);
+      if (round_trip.responses == 0 && round_trip.missing == 0) {
+        continue;
+      }
+      std::string prefix = driver.deviceName() + " " + API_CLASS_NAMES[i];
+      if (round_trip.responses) {
+        add_value(prefix + " RTT mean (ms)", 1e3 * round_trip.total / round_trip.responses);
+        add_value(prefix + " RTT max (ms)", 1e3 * round_trip.max);
+      }
+      add_value(prefix + " missing", round_trip.missing);
+      total.responses += round_trip.responses;
+      total.missing += round_trip.missing;
+      total.total += round_trip.total;
+      total.max = std::max(total.max, round_trip.max);
+    }
+    metrics.data.push_back(total.responses ? total.total / total.responses : 0.0);
+    metrics.data.push_back(total.max);
+    metrics.data.push_back(total.missing);
+    missing += total.missing;
+    driver.clearBusStats();
+  }
+
+  char message[128];
+  snprintf(
+    message, sizeof(message),
+    "Bus load %.0f%%, %u missing responses, %u stale drivers, %" PRIu64 " dropped frames",
+    100 * load, missing, stale, tx_dropped);
+  status.message = message;
+  status.level = load > 0.8 || missing || stale || tx_dropped ?
+    diagnostic_msgs::msg::DiagnosticStatus::WARN : diagnostic_msgs::msg::DiagnosticStatus::OK;
+
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = now;
+  diagnostics.status.push_back(status);
+  diagnostics_pub_->publish(diagnostics);
+  metrics_pub_->publish(metrics);
+
+  rx_frames_ = 0;
+  rx_bits_ = 0;
+  if (tx_batch_) {
+    tx_batch_->clearDroppedFrames();
+  }
+  bus_stats_start_ = now;
+}
+
 void MultiPumaNode::cmdCallback(const sensor_msgs::msg::JointState::SharedPtr msg)
 {
+  std::lock_guard<std::mutex> lock(driver_mutex_);
   if (active_) {
-    for (auto & driver : drivers_) {
-      for (int i = 0; i < static_cast<int>(msg->name.size()); i++) {
-        if (driver.deviceName() == msg->name[i]) {
-          if (desired_mode_ == clearpath_motor_msgs::msg::PumaStatus::MODE_VOLTAGE) {
-            driver.commandDutyCycle(msg->velocity[i]);
-          } else if (desired_mode_ == clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED) {
-            driver.commandSpeed(msg->velocity[i]);
-          }
-        }
+    const size_t count = std::min(msg->name.size(), msg->velocity.size());
+    for (size_t i = 0; i < count; i++) {
+      auto it = name_drivers_.find(msg->name[i]);
+      if (it == name_drivers_.end()) {
+        continue;
       }
+      auto driver = it->second;
+      if (desired_mode_ == clearpath_motor_msgs::msg::PumaStatus::MODE_VOLTAGE) {
+        driver->commandDutyCycle(msg->velocity[i]);
+      } else if (desired_mode_ == clearpath_motor_msgs::msg::PumaStatus::MODE_SPEED) {
+        driver->commandSpeed(msg->velocity[i]);
+      }
+    }
+    // Staged set-points take effect together on the sync broadcast.
+    if (sync_group_ && !drivers_.empty()) {
+      drivers_.front().sendSync(sync_group_);
+    }
+    if (tx_batch_) {
+      tx_batch_->flush();
     }
   }
 }
@@ -244,6 +524,26 @@ bool MultiPumaNode::areAllActive()
 
 void MultiPumaNode::run()
 {
+  std::lock_guard<std::mutex> lock(driver_mutex_);
+  // Process all received messages through the driver they are addressed to, before
+  // configuring so that readbacks of the last burst are seen.
+  if (rx_batch_) {
+    while (size_t count = rx_batch_->receive()) {
+      for (size_t i = 0; i < count; i++) {
+        int64_t stamp = rx_batch_->frame(i, *recv_msg_);
+        rx_frames_++;
+        rx_bits_ += puma_motor_driver::Driver::frameBits(*recv_msg_);
+        device_drivers_.dispatch(recv_msg_, stamp);
+      }
+    }
+  } else {
+    while (interface_->recv(recv_msg_)) {
+      rx_frames_++;
+      rx_bits_ += puma_motor_driver::Driver::frameBits(*recv_msg_);
+      device_drivers_.dispatch(recv_msg_);
+    }
+  }
+
   if (active_) {
     // Checks to see if power flag has been reset for each driver
     for (auto & driver : drivers_) {
@@ -258,9 +558,12 @@ void MultiPumaNode::run()
       }
     }
     // Queue data requests for the drivers in order to assemble an amalgamated status message.
+    // Drivers streaming periodic status only need their set-point polled once a second.
     for (auto & driver : drivers_) {
       driver.requestStatusMessages();
-      driver.requestFeedbackSetpoint();
+      if (!driver.periodicStatus() || status_count_ % freq_ == 0) {
+        driver.requestFeedbackSetpoint();
+      }
     }
   } else {
     // Set parameters for each driver.
@@ -269,13 +572,6 @@ void MultiPumaNode::run()
     }
   }
 
-  // Process all received messages through the connected driver instances.
-  while (interface_->recv(recv_msg_)) {
-    for (auto & driver : drivers_) {
-      driver.processMessage(recv_msg_);
-    }
-  }
-
   // Check parameters of each driver instance.
   if (!active_) {
     for (auto & driver : drivers_) {
@@ -283,6 +579,11 @@ void MultiPumaNode::run()
     }
   }
 
+  // Send this cycle's requests and configuration together.
+  if (tx_batch_) {
+    tx_batch_->flush();
+  }
+
   // Verify that the all drivers are configured.
   if (areAllActive() == true && active_ == false) {
     active_ = true;
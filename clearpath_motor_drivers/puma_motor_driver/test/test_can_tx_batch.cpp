@@ -0,0 +1,173 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "puma_motor_driver/can_tx_batch.hpp"
+
+// These tests need a virtual CAN interface:
+//   ip link add dev vcan0 type vcan && ip link set up vcan0
+static const char * const CANBUS_DEV = "vcan0";
+
+class CanTxBatchTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    if (if_nametoindex(CANBUS_DEV) == 0) {
+      GTEST_SKIP() << CANBUS_DEV << " is not available";
+    }
+    listener_ = openSocket();
+    ASSERT_GE(listener_, 0);
+  }
+
+  void TearDown() override
+  {
+    if (listener_ >= 0) {
+      close(listener_);
+    }
+  }
+
+  static int openSocket()
+  {
+    int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK, CAN_RAW);
+    if (fd < 0) {
+      return -1;
+    }
+    struct sockaddr_can addr = {};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = if_nametoindex(CANBUS_DEV);
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  static uint64_t txPackets()
+  {
+    std::ifstream file(std::string("/sys/class/net/") + CANBUS_DEV + "/statistics/tx_packets");
+    uint64_t packets = 0;
+    file >> packets;
+    return packets;
+  }
+
+  // Number of frames the listener receives before the bus goes quiet for timeout_ms.
+  size_t drain(int timeout_ms = 100)
+  {
+    size_t received = 0;
+    struct pollfd fd = {listener_, POLLIN, 0};
+    while (poll(&fd, 1, timeout_ms) > 0) {
+      struct can_frame frame;
+      while (read(listener_, &frame, sizeof(frame)) == sizeof(frame)) {
+        received++;
+      }
+    }
+    return received;
+  }
+
+  static can_msgs::msg::Frame frame(uint32_t id)
+  {
+    can_msgs::msg::Frame msg;
+    msg.id = id;
+    msg.is_extended = true;
+    msg.dlc = 8;
+    for (size_t i = 0; i < msg.data.size(); i++) {
+      msg.data[i] = id + i;
+    }
+    return msg;
+  }
+
+  int listener_ = -1;
+};
+
+TEST_F(CanTxBatchTest, ListenerSeesOtherLocalSockets)
+{
+  // Loopback is on by default, so a plain socket's frames reach the listener. This is what
+  // makes the absence of CanTxBatch frames below meaningful.
+  int sender = openSocket();
+  ASSERT_GE(sender, 0);
+  struct can_frame sent = {};
+  sent.can_id = 0x123;
+  sent.can_dlc = 1;
+  EXPECT_EQ(sizeof(sent), static_cast<size_t>(write(sender, &sent, sizeof(sent))));
+  close(sender);
+
+  EXPECT_EQ(1u, drain());
+}
+
+TEST_F(CanTxBatchTest, FlushTransmitsQueuedFrames)
+{
+  puma_motor_driver::CanTxBatch batch(CANBUS_DEV);
+  ASSERT_TRUE(batch.isOpen());
+
+  uint64_t before = txPackets();
+  const size_t count = 10;
+  for (size_t i = 0; i < count; i++) {
+    batch.queue(frame(i));
+  }
+  EXPECT_EQ(count, batch.flush());
+  EXPECT_EQ(0u, batch.flush());
+
+  EXPECT_EQ(before + count, txPackets());
+  EXPECT_EQ(0u, batch.droppedFrames());
+}
+
+TEST_F(CanTxBatchTest, FullBatchIsSentBeforeQueueing)
+{
+  puma_motor_driver::CanTxBatch batch(CANBUS_DEV);
+  ASSERT_TRUE(batch.isOpen());
+
+  uint64_t before = txPackets();
+  const size_t count = 2 * puma_motor_driver::CanTxBatch::MAX_FRAMES + 10;
+  for (size_t i = 0; i < count; i++) {
+    batch.queue(frame(i));
+  }
+  EXPECT_EQ(10u, batch.flush());
+
+  EXPECT_EQ(before + count, txPackets());
+  EXPECT_EQ(0u, batch.droppedFrames());
+}
+
+TEST_F(CanTxBatchTest, LoopbackIsOff)
+{
+  puma_motor_driver::CanTxBatch batch(CANBUS_DEV);
+  ASSERT_TRUE(batch.isOpen());
+
+  for (uint32_t i = 0; i < 20; i++) {
+    batch.queue(frame(i));
+  }
+  ASSERT_EQ(20u, batch.flush());
+
+  EXPECT_EQ(0u, drain());
+}
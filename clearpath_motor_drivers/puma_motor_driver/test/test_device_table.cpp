@@ -0,0 +1,111 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "puma_motor_driver/can_proto.hpp"
+#include "puma_motor_driver/device_table.hpp"
+#include "puma_motor_driver/driver.hpp"
+
+using puma_motor_driver::DeviceTable;
+using puma_motor_driver::Driver;
+
+namespace
+{
+// Fault status response from a device, carrying its own device number
+can_msgs::msg::Frame::SharedPtr faultResponse(const uint8_t device_number)
+{
+  auto msg = std::make_shared<can_msgs::msg::Frame>();
+  msg->id = LM_API_STATUS_FAULT | device_number;
+  msg->is_extended = true;
+  msg->dlc = 1;
+  msg->data[0] = device_number;
+  return msg;
+}
+
+std::vector<Driver> makeDrivers(const std::vector<uint8_t> & device_numbers)
+{
+  std::vector<Driver> drivers;
+  for (uint8_t device_number : device_numbers) {
+    drivers.push_back(
+      Driver(nullptr, nullptr, device_number, "puma" + std::to_string(device_number)));
+  }
+  return drivers;
+}
+
+// Every frame reaches only the driver it is addressed to
+void expectRouted(const std::vector<uint8_t> & device_numbers)
+{
+  std::vector<Driver> drivers = makeDrivers(device_numbers);
+  DeviceTable table;
+  table.assign(drivers);
+
+  for (uint8_t device_number = 0; device_number <= CAN_MSGID_DEVNO_M; device_number++) {
+    bool assigned = false;
+    for (const Driver & driver : drivers) {
+      assigned |= driver.deviceNumber() == device_number;
+    }
+    EXPECT_EQ(table.dispatch(faultResponse(device_number)), assigned) <<
+      "device " << static_cast<int>(device_number);
+  }
+
+  for (Driver & driver : drivers) {
+    ASSERT_TRUE(driver.receivedFault()) << driver.deviceName();
+    EXPECT_EQ(driver.lastFault(), driver.deviceNumber()) << driver.deviceName();
+  }
+}
+}  // namespace
+
+TEST(DeviceTable, RoutesFourDevices)
+{
+  expectRouted({2, 3, 4, 5});
+}
+
+TEST(DeviceTable, RoutesEightDevices)
+{
+  expectRouted({0, 1, 7, 12, 31, 32, 62, 63});
+}
+
+TEST(DeviceTable, EmptyTableDropsEverything)
+{
+  DeviceTable table;
+  EXPECT_FALSE(table.dispatch(faultResponse(0)));
+  EXPECT_FALSE(table.dispatch(faultResponse(CAN_MSGID_DEVNO_M)));
+}
+
+// Each device number resolves to its own driver, unassigned numbers to none
+TEST(DeviceTable, FindsDriverByDeviceNumber)
+{
+  std::vector<Driver> drivers = makeDrivers({2, 3, 4, 5, 6, 7, 8, 9});
+  DeviceTable table;
+  table.assign(drivers);
+
+  for (Driver & driver : drivers) {
+    EXPECT_EQ(table.find(*faultResponse(driver.deviceNumber())), &driver);
+  }
+  EXPECT_EQ(table.find(*faultResponse(10)), nullptr);
+}
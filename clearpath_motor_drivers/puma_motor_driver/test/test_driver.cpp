@@ -0,0 +1,222 @@
+/**
+Software License Agreement (BSD)
+
+\authors   Luis Camero <lcamero@clearpathrobotics.com>
+\copyright Copyright (c) 2025, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "puma_motor_driver/can_proto.hpp"
+#include "puma_motor_driver/driver.hpp"
+
+using puma_motor_driver::Driver;
+
+namespace
+{
+constexpr uint8_t DEVICE_NUMBER = 5;
+constexpr uint32_t API_COUNT = (CAN_MSGID_API_M >> CAN_MSGID_API_S) + 1;
+
+uint32_t apiNumber(const uint32_t id)
+{
+  return (id & CAN_MSGID_API_M) >> CAN_MSGID_API_S;
+}
+
+// Response from DEVICE_NUMBER to a 10 bit API number, carrying the API number in its data
+can_msgs::msg::Frame::SharedPtr response(const uint32_t api)
+{
+  auto msg = std::make_shared<can_msgs::msg::Frame>();
+  msg->id = CAN_MSGID_MFR_LM | CAN_MSGID_DTYPE_MOTOR | (api << CAN_MSGID_API_S) | DEVICE_NUMBER;
+  msg->is_extended = true;
+  msg->dlc = 8;
+  msg->data = {static_cast<uint8_t>(api & 0xff), static_cast<uint8_t>(api >> 8), 0, 0, 0, 0, 0, 0};
+  return msg;
+}
+
+// Cached APIs with a received flag, and the flag
+struct ReceivedFlag
+{
+  uint32_t id;
+  std::string name;
+  std::function<bool(Driver &)> received;
+};
+
+const std::vector<ReceivedFlag> RECEIVED_FLAGS = {
+  {LM_API_STATUS_VOLTOUT, "DutyCycle", &Driver::receivedDutyCycle},
+  {LM_API_STATUS_VOLTBUS, "BusVoltage", &Driver::receivedBusVoltage},
+  {LM_API_STATUS_CURRENT, "Current", &Driver::receivedCurrent},
+  {LM_API_STATUS_TEMP, "Temperature", &Driver::receivedTemperature},
+  {LM_API_STATUS_POS, "Position", &Driver::receivedPosition},
+  {LM_API_STATUS_SPD, "Speed", &Driver::receivedSpeed},
+  {LM_API_STATUS_FAULT, "Fault", &Driver::receivedFault},
+  {LM_API_STATUS_POWER, "Power", &Driver::receivedPower},
+  {LM_API_STATUS_CMODE, "Mode", &Driver::receivedMode},
+  {LM_API_STATUS_VOUT, "OutVoltage", &Driver::receivedOutVoltage},
+  {CPR_API_STATUS_ANALOG, "AnalogInput", &Driver::receivedAnalogInput},
+  {LM_API_VOLT_SET, "DutyCycleSetpoint", &Driver::receivedDutyCycleSetpoint},
+  {LM_API_SPD_SET, "SpeedSetpoint", &Driver::receivedSpeedSetpoint},
+  {LM_API_ICTRL_SET, "CurrentSetpoint", &Driver::receivedCurrentSetpoint},
+  {LM_API_POS_SET, "PositionSetpoint", &Driver::receivedPositionSetpoint},
+};
+
+// Flags set by each periodic status message
+std::vector<std::string> periodicStatusFlags(const uint32_t api)
+{
+  if (api == apiNumber(LM_API_PSTAT_DATA_S0)) {
+    return {"Position", "Speed"};
+  }
+  if (api == apiNumber(LM_API_PSTAT_DATA_S1)) {
+    return {"DutyCycle", "BusVoltage", "Current", "Temperature"};
+  }
+  if (api == apiNumber(LM_API_PSTAT_DATA_S2)) {
+    return {"OutVoltage", "Fault"};
+  }
+  return {};
+}
+
+// Periodic status messages carry several fields each, and are checked separately
+bool isPeriodicStatus(const uint32_t api)
+{
+  return ((api << CAN_MSGID_API_S) & CAN_MSGID_API_CLASS_M) == CAN_API_MC_PSTAT;
+}
+}  // namespace
+
+// The driver does not touch the bus or the node while processing received frames.
+TEST(DriverFields, EveryApiSetsOnlyItsOwnFlag)
+{
+  for (uint32_t api = 0; api < API_COUNT; api++) {
+    if (isPeriodicStatus(api)) {
+      continue;
+    }
+    Driver driver(nullptr, nullptr, DEVICE_NUMBER, "test");
+    driver.processMessage(response(api));
+
+    std::vector<std::string> expected;
+    for (const ReceivedFlag & flag : RECEIVED_FLAGS) {
+      if (apiNumber(flag.id) == api) {
+        expected.push_back(flag.name);
+      }
+    }
+
+    std::vector<std::string> received;
+    for (const ReceivedFlag & flag : RECEIVED_FLAGS) {
+      if (flag.received(driver)) {
+        received.push_back(flag.name);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(received.begin(), received.end());
+    EXPECT_EQ(received, expected) << "API 0x" << std::hex << api;
+  }
+}
+
+// With every API answered, each field holds the response to its own API. Two APIs sharing a
+// slot would leave one of them reading the other's data.
+TEST(DriverFields, FieldsDoNotAlias)
+{
+  Driver driver(nullptr, nullptr, DEVICE_NUMBER, "test");
+  for (uint32_t api = 0; api < API_COUNT; api++) {
+    if (!isPeriodicStatus(api)) {
+      driver.processMessage(response(api));
+    }
+  }
+
+  EXPECT_EQ(driver.lastFault(), apiNumber(LM_API_STATUS_FAULT) & 0xff);
+  EXPECT_EQ(driver.lastPower(), apiNumber(LM_API_STATUS_POWER) & 0xff);
+  EXPECT_EQ(driver.lastMode(), apiNumber(LM_API_STATUS_CMODE) & 0xff);
+  EXPECT_EQ(driver.posEncoderRef(), apiNumber(LM_API_POS_REF) & 0xff);
+  EXPECT_EQ(driver.spdEncoderRef(), apiNumber(LM_API_SPD_REF) & 0xff);
+  EXPECT_EQ(driver.encoderCounts(), apiNumber(LM_API_CFG_ENC_LINES));
+
+  // Gains are read from the speed control APIs in the default mode
+  EXPECT_EQ(driver.getP(), apiNumber(LM_API_SPD_PC) / 65536.0);
+  EXPECT_EQ(driver.getI(), apiNumber(LM_API_SPD_IC) / 65536.0);
+  EXPECT_EQ(driver.getD(), apiNumber(LM_API_SPD_DC) / 65536.0);
+  EXPECT_EQ(driver.lastBusVoltage(), apiNumber(LM_API_STATUS_VOLTBUS) / 256.0f);
+  EXPECT_EQ(driver.lastTemperature(), apiNumber(LM_API_STATUS_TEMP) / 256.0f);
+  EXPECT_EQ(driver.lastAnalogInput(), apiNumber(CPR_API_STATUS_ANALOG) / 256.0f);
+  EXPECT_EQ(driver.statusCurrentGet(), apiNumber(LM_API_ICTRL_SET) / 256.0f);
+}
+
+TEST(DriverFields, IgnoresOtherDevices)
+{
+  Driver driver(nullptr, nullptr, DEVICE_NUMBER + 1, "test");
+  driver.processMessage(response(apiNumber(LM_API_STATUS_POS)));
+  EXPECT_FALSE(driver.receivedPosition());
+}
+
+// Each periodic status message sets the flags of the fields in its layout, and no others.
+TEST(DriverFields, PeriodicStatusSetsItsFields)
+{
+  for (uint32_t id : {LM_API_PSTAT_DATA_S0, LM_API_PSTAT_DATA_S1, LM_API_PSTAT_DATA_S2}) {
+    Driver driver(nullptr, nullptr, DEVICE_NUMBER, "test");
+    driver.processMessage(response(apiNumber(id)));
+
+    std::vector<std::string> expected = periodicStatusFlags(apiNumber(id));
+    std::vector<std::string> received;
+    for (const ReceivedFlag & flag : RECEIVED_FLAGS) {
+      if (flag.received(driver)) {
+        received.push_back(flag.name);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(received.begin(), received.end());
+    EXPECT_EQ(received, expected) << "API 0x" << std::hex << apiNumber(id);
+  }
+}
+
+// Periodic status data is unpacked into the same fields the polled status responses use.
+TEST(DriverFields, PeriodicStatusFillsStatusFields)
+{
+  Driver driver(nullptr, nullptr, DEVICE_NUMBER, "test");
+  auto msg = response(apiNumber(LM_API_PSTAT_DATA_S1));
+  // Duty cycle, current, bus voltage and temperature, two little endian bytes each
+  msg->data = {0x00, 0x40, 0x00, 0x03, 0x00, 0x18, 0x80, 0x1e};
+  driver.processMessage(msg);
+
+  EXPECT_FLOAT_EQ(driver.lastBusVoltage(), 24.0f);
+  EXPECT_FLOAT_EQ(driver.lastCurrent(), 3.0f);
+  EXPECT_FLOAT_EQ(driver.lastTemperature(), 30.5f);
+}
+
+namespace
+{
+can_msgs::msg::Frame frame(const bool extended, const uint8_t dlc)
+{
+  can_msgs::msg::Frame msg;
+  msg.is_extended = extended;
+  msg.dlc = dlc;
+  return msg;
+}
+}  // namespace
+
+// Worst case stuffed lengths, interframe space included
+TEST(DriverBusStats, FrameBits)
+{
+  EXPECT_EQ(Driver::frameBits(frame(false, 0)), 55u);
+  EXPECT_EQ(Driver::frameBits(frame(false, 8)), 135u);
+  EXPECT_EQ(Driver::frameBits(frame(true, 0)), 80u);
+  EXPECT_EQ(Driver::frameBits(frame(true, 8)), 160u);
+}